@@ -0,0 +1,209 @@
+#include <sstream>
+#include "EngineServer.h"
+#include "GameRecord.h"
+#include "MiniMax.h"
+#include "ProofNumberSearch.h"
+
+EngineServer::EngineServer(size_t threadCount, std::function<void(const std::string&)> output) :
+        output(output),
+        generationStartTicks(std::chrono::steady_clock::now().time_since_epoch().count()),
+        workerPool(threadCount) {}
+
+EngineServer::~EngineServer() {
+    for (std::pair<const std::string, std::shared_ptr<EngineSession>>& session : sessions) {
+        session.second->stopRequested = true;
+    }
+}
+
+void EngineServer::send(const std::string& line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    output(line);
+}
+
+void EngineServer::send(const EngineSession& session, const std::string& line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    if (!session.deleted) {
+        output(line);
+    }
+}
+
+std::shared_ptr<EngineSession> EngineServer::findIdleSession(const std::string& name) {
+    auto session = sessions.find(name);
+    if (session == sessions.end()) {
+        send("error unknown session " + name);
+        return nullptr;
+    }
+    if (session->second->searching) {
+        send("error session " + name + " is searching");
+        return nullptr;
+    }
+    return session->second;
+}
+
+bool EngineServer::handleCommand(const std::string& line) {
+    std::istringstream tokens(line);
+    std::string command;
+    std::string name;
+    if (!(tokens >> command)) {
+        return true;
+    }
+    if (command == "quit") {
+        return false;
+    }
+    if (command == "isready") {
+        send("readyok");
+        return true;
+    }
+    if (!(tokens >> name)) {
+        send("error " + command + " requires a session");
+        return true;
+    }
+    if (command == "new") {
+        if (sessions.count(name)) {
+            send("error session " + name + " already exists");
+        } else {
+            sessions[name] = std::make_shared<EngineSession>();
+        }
+    } else if (command == "delete") {
+        auto session = sessions.find(name);
+        if (session != sessions.end()) {
+            // A running search keeps its own reference to the session and finishes in the background silently.
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                session->second->deleted = true;
+            }
+            session->second->stopRequested = true;
+            sessions.erase(session);
+        }
+    } else if (command == "stop") {
+        auto session = sessions.find(name);
+        if (session != sessions.end()) {
+            session->second->stopRequested = true;
+        }
+    } else if (command == "position" || command == "move") {
+        std::shared_ptr<EngineSession> session = findIdleSession(name);
+        if (session == nullptr) {
+            return true;
+        }
+        GameState state = session->state;
+        std::string token;
+        if (command == "position") {
+            if (!(tokens >> token) || token != "startpos") {
+                send("error position requires startpos");
+                return true;
+            }
+            state = GameState();
+            if (tokens >> token && token != "moves") {
+                send("error unexpected " + token);
+                return true;
+            }
+        }
+        // The session is only updated if every move is valid.
+        while (tokens >> token) {
+            uint8_t move = moveFromString(token);
+            if (move == NO_MOVE || !isValidMove(state, move)) {
+                send("error invalid move " + token);
+                return true;
+            }
+            applyMove(state, move);
+        }
+        session->state = state;
+    } else if (command == "go") {
+        std::shared_ptr<EngineSession> session = findIdleSession(name);
+        if (session == nullptr) {
+            return true;
+        }
+        int maxDepth = DEFAULT_SERVER_SEARCH_DEPTH;
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+        std::string option;
+        while (tokens >> option) {
+            long long value;
+            if (!(tokens >> value) || value <= 0) {
+                send("error " + option + " requires a positive value");
+                return true;
+            }
+            if (option == "depth") {
+                maxDepth = std::min<long long>(value, MAX_SEARCH_DEPTH);
+            } else if (option == "movetime") {
+                // The time limit starts when the command is received, so it includes time spent waiting for a worker.
+                deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(value);
+            } else {
+                send("error unknown option " + option);
+                return true;
+            }
+        }
+        if (session->state.isGameOver()) {
+            send("bestmove " + name + " none");
+            return true;
+        }
+        session->stopRequested = false;
+        session->searching = true;
+        GameState state = session->state;
+        workerPool.submit([this, name, session, state, maxDepth, deadline]() {
+            search(name, session, state, maxDepth, deadline);
+        });
+    } else {
+        send("error unknown command " + command);
+    }
+    return true;
+}
+
+// Only the search that finds the interval elapsed advances the generation, however many start at once.
+void EngineServer::advanceGeneration() {
+    int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+    int64_t start = generationStartTicks.load(std::memory_order_relaxed);
+    if (now - start >= std::chrono::steady_clock::duration(SERVER_GENERATION_INTERVAL).count() &&
+        generationStartTicks.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+        transpositionTable.newSearch();
+    }
+}
+
+// Iterative deepening searches one ply deeper at a time until the depth limit is reached or the
+// search is stopped. The move from the deepest completed depth is played; if not even the first
+// depth completed, the best move found by the partial search is played instead.
+void EngineServer::search(const std::string& name, std::shared_ptr<EngineSession> session, GameState state,
+                          int8_t maxDepth, std::chrono::steady_clock::time_point deadline) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    advanceGeneration();
+    SearchContext context;
+    context.stopRequested = &session->stopRequested;
+    context.deadline = deadline;
+    SearchResult best = {state, 0};
+    // A proven win in a race is played without searching further.
+    // The proof has its own context and at most half of the move's time, so a race it cannot prove
+    // leaves minimax time to search. Only a stop request, which minimax also sees, ends both.
+    if (isRacePosition(state)) {
+        SearchContext proofContext;
+        proofContext.stopRequested = context.stopRequested;
+        proofContext.deadline = std::min(start + (deadline - start) / 2, start + PROOF_TIME_LIMIT);
+        ProofResult proof = solveRace(state, DEFAULT_PROOF_MEMORY_BUDGET, DEFAULT_PROOF_NODE_LIMIT, proofContext);
+        if (proof.proven) {
+            std::string line;
+            for (uint8_t move : proof.winningLine) {
+                line += " " + moveToString(move);
+            }
+            std::chrono::milliseconds elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            send(*session, "info " + name + " proof win nodes " + std::to_string(proofContext.nodes) +
+                 " time " + std::to_string(elapsed.count()) + " pv" + line);
+            session->searching = false;
+            send(*session, "bestmove " + name + " " + moveToString(proof.winningLine.front()));
+            return;
+        }
+    }
+    for (int8_t depth = 1; depth <= maxDepth; depth++) {
+        SearchResult result = searchRoot(state, depth, context);
+        if (context.aborted) {
+            if (depth == 1) {
+                best = result;
+            }
+            break;
+        }
+        best = result;
+        std::chrono::milliseconds elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        send(*session, "info " + name + " depth " + std::to_string(depth) + " score " + std::to_string(best.score) +
+             " nodes " + std::to_string(context.nodes) + " time " + std::to_string(elapsed.count()) +
+             " pv " + moveToString(encodeMove(state, best.bestMove)));
+    }
+    session->searching = false;
+    send(*session, "bestmove " + name + " " + moveToString(encodeMove(state, best.bestMove)));
+}
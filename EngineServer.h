@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "GameState.h"
+#include "WorkerPool.h"
+
+// Every game served by the engine is a session with its own position.
+// The position is copied when a search starts, so a session only rejects
+// position changes while its own search is running.
+struct EngineSession {
+    GameState state;
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> searching{false};
+    // Set under the server's output mutex when the session is deleted, after which its running search
+    // sends nothing, so its lines can never be mistaken for those of a new session with the same name.
+    bool deleted = false;
+};
+
+// A line based text protocol for playing many games from one process.
+// Sessions are identified by a name chosen by the client and share one worker pool
+// and the global transposition table.
+//
+//   new <session>                                 start a session at the starting position
+//   position <session> startpos [moves <move>...] reset a session and apply moves
+//   move <session> <move>                         apply a move to a session
+//   go <session> [depth <plies>] [movetime <ms>]  search the session's position
+//   stop <session>                                finish a running search early
+//   delete <session>                              end a session, discarding the result of its search
+//   isready                                       replies readyok
+//   quit                                          stops every search and exits
+//
+// Searches reply asynchronously with one line per completed depth and a final move:
+//   info <session> depth <plies> score <score> nodes <nodes> time <ms> pv <move>
+//   info <session> proof win nodes <nodes> time <ms> pv <move>...   (a proven win in a race)
+//   bestmove <session> <move|none>
+// Malformed or rejected commands reply with: error <message>
+class EngineServer {
+    public:
+        EngineServer(size_t threadCount, std::function<void(const std::string&)> output);
+        ~EngineServer();
+
+        // Commands must be handled from a single thread. Returns false once quit is received.
+        bool handleCommand(const std::string& line);
+
+    private:
+        std::unordered_map<std::string, std::shared_ptr<EngineSession>> sessions;
+        std::function<void(const std::string&)> output;
+        std::mutex outputMutex;
+        // When the transposition table generation was last advanced, in steady clock ticks.
+        std::atomic<int64_t> generationStartTicks;
+        // The pool is declared last so that it is destroyed, and its jobs finished, first.
+        WorkerPool workerPool;
+
+        void send(const std::string& line);
+        void send(const EngineSession& session, const std::string& line);
+        std::shared_ptr<EngineSession> findIdleSession(const std::string& name);
+        void advanceGeneration();
+        void search(const std::string& name, std::shared_ptr<EngineSession> session, GameState state,
+                    int8_t maxDepth, std::chrono::steady_clock::time_point deadline);
+};
+
+// The depth searched by go when no depth is given, matching the GUI's opponent.
+constexpr int8_t DEFAULT_SERVER_SEARCH_DEPTH = 4;
+// Searches of many sessions interleave, so the server starts a new transposition table generation
+// at most this often rather than once per search. Entries stored within the current interval are
+// protected from shallower ones, and the 8 bit generation wraps after minutes instead of 256 searches.
+constexpr std::chrono::milliseconds SERVER_GENERATION_INTERVAL(1000);
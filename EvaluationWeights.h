@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+// Evaluation weights, overwritten with tuned weights by tools/EvaluationTuner.cpp.
+// Hand picked weights the evaluation used before tuning, not yet fitted to recorded games.
+constexpr int16_t GOAL_DISTANCE_WEIGHT = 5;
+constexpr int16_t WALL_COUNT_WEIGHT = 1;
+constexpr int16_t PATH_SLACK_WEIGHT = 0;
+constexpr int16_t MOBILITY_WEIGHT = 0;
+constexpr int16_t TURN_WEIGHT = 0;
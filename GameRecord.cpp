@@ -0,0 +1,287 @@
+#include <cstring>
+#include <stdexcept>
+#include "GameRecord.h"
+
+namespace {
+    // Integers are written byte by byte so that databases are portable between hosts.
+    void writeLittleEndian(uint8_t* destination, uint64_t value, int byteCount) {
+        for (int i = 0; i < byteCount; i++) {
+            destination[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    uint64_t readLittleEndian(const uint8_t* source, int byteCount) {
+        uint64_t value = 0;
+        for (int i = 0; i < byteCount; i++) {
+            value |= static_cast<uint64_t>(source[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    int8_t square(std::pair<int8_t, int8_t> position) {
+        return position.first + position.second * BOARD_SIZE;
+    }
+
+    int8_t countTrailingZeros(uint64_t bits) {
+        int8_t count = 0;
+        while (!(bits & 1)) {
+            bits >>= 1;
+            count++;
+        }
+        return count;
+    }
+}
+
+bool PackedPosition::operator==(const PackedPosition& other) const {
+    return verticalWalls == other.verticalWalls &&
+           horizontalWalls == other.horizontalWalls &&
+           pawnsWallsAndTurn == other.pawnsWallsAndTurn;
+}
+
+PackedPosition encodePosition(const GameState& state) {
+    PackedPosition position;
+    position.verticalWalls = state.verticalWalls;
+    position.horizontalWalls = state.horizontalWalls;
+    position.pawnsWallsAndTurn = static_cast<uint32_t>(square(state.player1Position)) |
+                                 static_cast<uint32_t>(square(state.player2Position)) << 7 |
+                                 static_cast<uint32_t>(state.player1WallCount) << 14 |
+                                 static_cast<uint32_t>(state.player2WallCount) << 18 |
+                                 static_cast<uint32_t>(state.isPlayer1sTurn) << 22;
+    return position;
+}
+
+bool isValidPosition(const PackedPosition& position) {
+    uint32_t player1Square = position.pawnsWallsAndTurn & 0x7F;
+    uint32_t player2Square = (position.pawnsWallsAndTurn >> 7) & 0x7F;
+    uint32_t player1WallCount = (position.pawnsWallsAndTurn >> 14) & 0xF;
+    uint32_t player2WallCount = (position.pawnsWallsAndTurn >> 18) & 0xF;
+    return player1Square < PAWN_MOVE_COUNT && player2Square < PAWN_MOVE_COUNT && player1Square != player2Square &&
+           player1WallCount <= WALL_COUNT / 2 && player2WallCount <= WALL_COUNT / 2 &&
+           (position.pawnsWallsAndTurn >> 23) == 0;
+}
+
+GameState decodePosition(const PackedPosition& position) {
+    if (!isValidPosition(position)) {
+        throw std::invalid_argument("Invalid packed position");
+    }
+    GameState state;
+    int8_t player1Square = position.pawnsWallsAndTurn & 0x7F;
+    int8_t player2Square = (position.pawnsWallsAndTurn >> 7) & 0x7F;
+    state.verticalWalls = position.verticalWalls;
+    state.horizontalWalls = position.horizontalWalls;
+    state.player1Position = {player1Square % BOARD_SIZE, player1Square / BOARD_SIZE};
+    state.player2Position = {player2Square % BOARD_SIZE, player2Square / BOARD_SIZE};
+    state.player1WallCount = (position.pawnsWallsAndTurn >> 14) & 0xF;
+    state.player2WallCount = (position.pawnsWallsAndTurn >> 18) & 0xF;
+    state.isPlayer1sTurn = (position.pawnsWallsAndTurn >> 22) & 1;
+    state.computeStateHash();
+    state.setGoalDistances();
+    return state;
+}
+
+void writePackedPosition(uint8_t* destination, const PackedPosition& position) {
+    writeLittleEndian(destination, position.verticalWalls, 8);
+    writeLittleEndian(destination + 8, position.horizontalWalls, 8);
+    writeLittleEndian(destination + 16, position.pawnsWallsAndTurn, 4);
+}
+
+PackedPosition readPackedPosition(const uint8_t* source) {
+    PackedPosition position;
+    position.verticalWalls = readLittleEndian(source, 8);
+    position.horizontalWalls = readLittleEndian(source + 8, 8);
+    position.pawnsWallsAndTurn = static_cast<uint32_t>(readLittleEndian(source + 16, 4));
+    return position;
+}
+
+// A move is identified by the wall that was added or, if no wall was added,
+// by the new square of the player who moved.
+uint8_t encodeMove(const GameState& before, const GameState& after) {
+    uint64_t newVerticalWalls = after.verticalWalls ^ before.verticalWalls;
+    if (newVerticalWalls) {
+        return VERTICAL_WALL_MOVE_OFFSET + countTrailingZeros(newVerticalWalls);
+    }
+    uint64_t newHorizontalWalls = after.horizontalWalls ^ before.horizontalWalls;
+    if (newHorizontalWalls) {
+        return HORIZONTAL_WALL_MOVE_OFFSET + countTrailingZeros(newHorizontalWalls);
+    }
+    return square(before.isPlayer1sTurn ? after.player1Position : after.player2Position);
+}
+
+void applyMove(GameState& state, uint8_t move) {
+    if (move >= HORIZONTAL_WALL_MOVE_OFFSET + (BOARD_SIZE - 1) * (BOARD_SIZE - 1)) {
+        throw std::invalid_argument("Invalid move " + std::to_string(move));
+    }
+    if (move < VERTICAL_WALL_MOVE_OFFSET) {
+        state.movePawn(move % BOARD_SIZE, move / BOARD_SIZE);
+    } else if (move < HORIZONTAL_WALL_MOVE_OFFSET) {
+        int8_t wallIndex = move - VERTICAL_WALL_MOVE_OFFSET;
+        state.placeVerticalWall(wallIndex % (BOARD_SIZE - 1), wallIndex / (BOARD_SIZE - 1));
+    } else {
+        int8_t wallIndex = move - HORIZONTAL_WALL_MOVE_OFFSET;
+        state.placeHorizontalWall(wallIndex % (BOARD_SIZE - 1), wallIndex / (BOARD_SIZE - 1));
+    }
+}
+
+bool isValidMove(const GameState& state, uint8_t move) {
+    if (state.isGameOver() || move >= HORIZONTAL_WALL_MOVE_OFFSET + (BOARD_SIZE - 1) * (BOARD_SIZE - 1)) {
+        return false;
+    }
+    if (move < VERTICAL_WALL_MOVE_OFFSET) {
+        for (const std::pair<int8_t, int8_t>& pawnMove : state.getValidPawnMoves()) {
+            if (square(pawnMove) == move) {
+                return true;
+            }
+        }
+        return false;
+    }
+    int8_t playerWalls = state.isPlayer1sTurn ? state.player1WallCount : state.player2WallCount;
+    if (playerWalls == 0) {
+        return false;
+    }
+    bool isVertical = move < HORIZONTAL_WALL_MOVE_OFFSET;
+    int8_t wallIndex = move - (isVertical ? VERTICAL_WALL_MOVE_OFFSET : HORIZONTAL_WALL_MOVE_OFFSET);
+    int8_t x = wallIndex % (BOARD_SIZE - 1);
+    int8_t y = wallIndex / (BOARD_SIZE - 1);
+    if (isVertical ? !state.canPlaceVerticalWall(x, y) : !state.canPlaceHorizontalWall(x, y)) {
+        return false;
+    }
+    GameState newState = state;
+    applyMove(newState, move);
+    return newState.isBoardValid();
+}
+
+std::string moveToString(uint8_t move) {
+    if (move < VERTICAL_WALL_MOVE_OFFSET) {
+        return {static_cast<char>('a' + move % BOARD_SIZE), static_cast<char>('1' + move / BOARD_SIZE)};
+    }
+    bool isVertical = move < HORIZONTAL_WALL_MOVE_OFFSET;
+    int8_t wallIndex = move - (isVertical ? VERTICAL_WALL_MOVE_OFFSET : HORIZONTAL_WALL_MOVE_OFFSET);
+    return {static_cast<char>('a' + wallIndex % (BOARD_SIZE - 1)),
+            static_cast<char>('1' + wallIndex / (BOARD_SIZE - 1)),
+            isVertical ? 'v' : 'h'};
+}
+
+uint8_t moveFromString(const std::string& text) {
+    if (text.size() < 2 || text.size() > 3) {
+        return NO_MOVE;
+    }
+    int8_t x = text[0] - 'a';
+    int8_t y = text[1] - '1';
+    if (text.size() == 2) {
+        if (x < 0 || x >= BOARD_SIZE || y < 0 || y >= BOARD_SIZE) {
+            return NO_MOVE;
+        }
+        return x + y * BOARD_SIZE;
+    }
+    if (x < 0 || x >= BOARD_SIZE - 1 || y < 0 || y >= BOARD_SIZE - 1 || (text[2] != 'v' && text[2] != 'h')) {
+        return NO_MOVE;
+    }
+    return (text[2] == 'v' ? VERTICAL_WALL_MOVE_OFFSET : HORIZONTAL_WALL_MOVE_OFFSET) + x + y * (BOARD_SIZE - 1);
+}
+
+GameDatabaseWriter::GameDatabaseWriter(const std::string& path) : file(path, std::ios::binary | std::ios::trunc),
+                                                                  offset(GAME_DATABASE_HEADER_SIZE) {
+    if (!file) {
+        throw std::runtime_error("Failed to create game database " + path);
+    }
+    // The header is rewritten with the game count and index offset when the database is closed.
+    uint8_t header[GAME_DATABASE_HEADER_SIZE] = {};
+    file.write(reinterpret_cast<const char*>(header), GAME_DATABASE_HEADER_SIZE);
+}
+
+// Errors cannot be reported from the destructor, and a database whose index was not written is
+// rejected by readers, so a failure here is left for the reader to find.
+GameDatabaseWriter::~GameDatabaseWriter() {
+    try {
+        close();
+    } catch (const std::runtime_error&) {}
+}
+
+void GameDatabaseWriter::addGame(const GameState& startState, const std::vector<uint8_t>& moves, int8_t result) {
+    if (moves.size() > UINT16_MAX) {
+        throw std::length_error("Game has too many moves to be stored");
+    }
+    uint8_t record[PACKED_POSITION_SIZE + 3];
+    writePackedPosition(record, encodePosition(startState));
+    record[PACKED_POSITION_SIZE] = static_cast<uint8_t>(result);
+    writeLittleEndian(record + PACKED_POSITION_SIZE + 1, moves.size(), 2);
+    file.write(reinterpret_cast<const char*>(record), sizeof(record));
+    file.write(reinterpret_cast<const char*>(moves.data()), moves.size());
+    gameOffsets.push_back(offset);
+    offset += sizeof(record) + moves.size();
+}
+
+void GameDatabaseWriter::close() {
+    if (!file.is_open()) {
+        return;
+    }
+    std::vector<uint8_t> index(gameOffsets.size() * 8);
+    for (size_t i = 0; i < gameOffsets.size(); i++) {
+        writeLittleEndian(index.data() + i * 8, gameOffsets[i], 8);
+    }
+    file.write(reinterpret_cast<const char*>(index.data()), index.size());
+    // The header is only written if every game and the index were, so a failed write such as a full
+    // disk never produces a database that claims games it does not hold.
+    if (!file) {
+        file.close();
+        throw std::runtime_error("Failed to write game database");
+    }
+    uint8_t header[GAME_DATABASE_HEADER_SIZE] = {'Q', 'G', 'D', 'B'};
+    writeLittleEndian(header + 4, GAME_DATABASE_VERSION, 4);
+    writeLittleEndian(header + 8, gameOffsets.size(), 8);
+    writeLittleEndian(header + 16, offset, 8);
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(header), GAME_DATABASE_HEADER_SIZE);
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Failed to write game database");
+    }
+}
+
+GameDatabaseReader::GameDatabaseReader(const std::string& path) {
+    if (!file.open(path, false) || file.size() < GAME_DATABASE_HEADER_SIZE) {
+        throw std::runtime_error("Failed to open game database " + path);
+    }
+    const uint8_t* header = file.data();
+    if (std::memcmp(header, "QGDB", 4) != 0 || readLittleEndian(header + 4, 4) != GAME_DATABASE_VERSION) {
+        throw std::runtime_error("Unsupported game database " + path);
+    }
+    gameCount = readLittleEndian(header + 8, 8);
+    indexOffset = readLittleEndian(header + 16, 8);
+    // A database that was not closed has no index and is rejected rather than partially read.
+    // The checks are written so that no huge value read from the file can overflow them.
+    if (indexOffset < GAME_DATABASE_HEADER_SIZE || indexOffset > file.size() || gameCount > (file.size() - indexOffset) / 8) {
+        throw std::runtime_error("Truncated game database " + path);
+    }
+    file.adviseSequential();
+}
+
+uint64_t GameDatabaseReader::getGameCount() const {
+    return gameCount;
+}
+
+GameRecordView GameDatabaseReader::getGame(uint64_t index) const {
+    if (index >= gameCount) {
+        throw std::out_of_range("Game index out of range");
+    }
+    return readGame(readLittleEndian(file.data() + indexOffset + index * 8, 8));
+}
+
+GameRecordView GameDatabaseReader::readGame(uint64_t gameOffset) const {
+    // The index offset is at least GAME_DATABASE_HEADER_SIZE, so none of these subtractions can wrap.
+    if (gameOffset < GAME_DATABASE_HEADER_SIZE || gameOffset > indexOffset - (PACKED_POSITION_SIZE + 3)) {
+        throw std::runtime_error("Corrupt game database");
+    }
+    const uint8_t* record = file.data() + gameOffset;
+    GameRecordView game;
+    game.startPosition = readPackedPosition(record);
+    game.result = static_cast<int8_t>(record[PACKED_POSITION_SIZE]);
+    game.moveCount = static_cast<uint16_t>(readLittleEndian(record + PACKED_POSITION_SIZE + 1, 2));
+    game.moves = record + PACKED_POSITION_SIZE + 3;
+    // Moves can only be checked by replaying them, which is left to the caller.
+    if (game.moveCount > indexOffset - gameOffset - (PACKED_POSITION_SIZE + 3) || !isValidPosition(game.startPosition) ||
+        (game.result != PLAYER_1_WON && game.result != PLAYER_2_WON && game.result != UNFINISHED)) {
+        throw std::runtime_error("Corrupt game database");
+    }
+    return game;
+}
\ No newline at end of file
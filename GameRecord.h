@@ -0,0 +1,118 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "GameState.h"
+#include "MappedFile.h"
+
+// A position is stored canonically without its Zobrist hash or cached goal distances,
+// both of which are recomputed when the position is decoded.
+// The pawn squares, wall counts and turn are packed into a single 32 bit value:
+// bits 0-6 hold player 1's square, bits 7-13 hold player 2's square,
+// bits 14-17 and 18-21 hold the wall counts of players 1 and 2,
+// and bit 22 is set if it is player 1's turn.
+struct PackedPosition {
+    uint64_t verticalWalls;
+    uint64_t horizontalWalls;
+    uint32_t pawnsWallsAndTurn;
+
+    bool operator==(const PackedPosition& other) const;
+};
+
+// On disk a packed position occupies 20 bytes.
+constexpr size_t PACKED_POSITION_SIZE = 20;
+
+PackedPosition encodePosition(const GameState& state);
+// A position read from a file is only decoded if its squares, wall counts and unused bits are in range,
+// since out of range values would index past the Zobrist keys.
+bool isValidPosition(const PackedPosition& position);
+// Throws std::invalid_argument if the position is not valid.
+GameState decodePosition(const PackedPosition& position);
+void writePackedPosition(uint8_t* destination, const PackedPosition& position);
+PackedPosition readPackedPosition(const uint8_t* source);
+
+// A move is stored in a single byte.
+// Values below 81 are the square a pawn moves to, the next 64 values are vertical walls
+// and the 64 after that are horizontal walls, both indexed the same way as the wall bitboards.
+constexpr uint8_t PAWN_MOVE_COUNT = BOARD_SIZE * BOARD_SIZE;
+constexpr uint8_t VERTICAL_WALL_MOVE_OFFSET = PAWN_MOVE_COUNT;
+constexpr uint8_t HORIZONTAL_WALL_MOVE_OFFSET = VERTICAL_WALL_MOVE_OFFSET + (BOARD_SIZE - 1) * (BOARD_SIZE - 1);
+constexpr uint8_t NO_MOVE = 255;
+
+uint8_t encodeMove(const GameState& before, const GameState& after);
+// Throws std::invalid_argument if the move byte does not name a square or wall.
+// Moves read from a file should be checked with isValidMove before they are applied.
+void applyMove(GameState& state, uint8_t move);
+bool isValidMove(const GameState& state, uint8_t move);
+
+// In text a move is written as a column letter (a-i) followed by a row number (1-9).
+// Wall moves name the wall's cell in the same way and are suffixed with v or h.
+std::string moveToString(uint8_t move);
+// Returns NO_MOVE if the text is not a well formed move.
+uint8_t moveFromString(const std::string& text);
+
+// The result of a game is stored from player 1's perspective.
+constexpr int8_t PLAYER_1_WON = 1;
+constexpr int8_t PLAYER_2_WON = -1;
+constexpr int8_t UNFINISHED = 0;
+
+// A game database consists of a 32 byte header, a sequence of game records, and an index
+// holding the byte offset of every game record.
+// The header holds the magic bytes "QGDB", the format version, the number of games and the
+// offset of the index. A game record holds its starting position, its result, the number of
+// moves as a 16 bit value and one byte per move. All integers are stored little endian.
+constexpr size_t GAME_DATABASE_HEADER_SIZE = 32;
+constexpr uint32_t GAME_DATABASE_VERSION = 1;
+
+struct GameRecordView {
+    PackedPosition startPosition;
+    int8_t result;
+    uint16_t moveCount;
+    const uint8_t* moves;
+};
+
+// Games are streamed to disk as they are added and the index is written when the database is closed.
+class GameDatabaseWriter {
+    public:
+        GameDatabaseWriter(const std::string& path);
+        ~GameDatabaseWriter();
+
+        void addGame(const GameState& startState, const std::vector<uint8_t>& moves, int8_t result);
+        // Throws std::runtime_error if any game, the index or the header could not be written.
+        void close();
+
+    private:
+        std::ofstream file;
+        std::vector<uint64_t> gameOffsets;
+        uint64_t offset;
+};
+
+// The database is memory mapped so that scanning it never copies game records.
+class GameDatabaseReader {
+    public:
+        GameDatabaseReader(const std::string& path);
+
+        uint64_t getGameCount() const;
+        GameRecordView getGame(uint64_t index) const;
+        // Game records are visited in file order, which lets the operating system read ahead.
+        template <typename Callback>
+        void forEachGame(Callback callback) const;
+
+    private:
+        MappedFile file;
+        uint64_t gameCount;
+        uint64_t indexOffset;
+
+        GameRecordView readGame(uint64_t gameOffset) const;
+};
+
+template <typename Callback>
+void GameDatabaseReader::forEachGame(Callback callback) const {
+    uint64_t gameOffset = GAME_DATABASE_HEADER_SIZE;
+    for (uint64_t i = 0; i < gameCount; i++) {
+        GameRecordView game = readGame(gameOffset);
+        callback(game);
+        gameOffset += PACKED_POSITION_SIZE + 3 + game.moveCount;
+    }
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "GameState.h"
 
+thread_local std::unordered_map<uint64_t, std::pair<int8_t, int8_t>> goalDistanceCache;
+
 GameState::GameState() : 
         verticalWalls(0),
         horizontalWalls(0),
@@ -10,14 +12,30 @@ GameState::GameState() :
         isPlayer1sTurn(true),
         player1GoalDistance(8),
         player2GoalDistance(8) {
-    // The Zobrist hash of the current game state is computed by combining the bitstrings
-    // describing the position using the bitwise XOR operator.
+    computeStateHash();
+}
+
+// The Zobrist hash of the current game state is computed by combining the bitstrings
+// describing the position using the bitwise XOR operator.
+void GameState::computeStateHash() {
     stateHash = 0;
+    for (int8_t x = 0; x < BOARD_SIZE - 1; x++) {
+        for (int8_t y = 0; y < BOARD_SIZE - 1; y++) {
+            if (hasVerticalWall(x, y)) {
+                stateHash ^= zobristHash.verticalWalls[x][y];
+            }
+            if (hasHorizontalWall(x, y)) {
+                stateHash ^= zobristHash.horizontalWalls[x][y];
+            }
+        }
+    }
     stateHash ^= zobristHash.player1Position[player1Position.first][player1Position.second];
     stateHash ^= zobristHash.player2Position[player2Position.first][player2Position.second];
     stateHash ^= zobristHash.player1WallCount[player1WallCount];
     stateHash ^= zobristHash.player2WallCount[player2WallCount];
-    stateHash ^= zobristHash.isPlayer1sTurn;
+    if (isPlayer1sTurn) {
+        stateHash ^= zobristHash.isPlayer1sTurn;
+    }
 }
 
 int8_t GameState::wallBitIndex(int8_t x, int8_t y) const {
@@ -65,6 +83,9 @@ void GameState::setGoalDistances() {
     }
     player1GoalDistance = getGoalDistance(player1Position, 0);
     player2GoalDistance = getGoalDistance(player2Position, BOARD_SIZE - 1);
+    if (goalDistanceCache.size() >= GOAL_DISTANCE_CACHE_LIMIT) {
+        goalDistanceCache.clear();
+    }
     goalDistanceCache[stateHash] = {player1GoalDistance, player2GoalDistance};
 }
 
@@ -248,17 +269,77 @@ bool GameState::isGameOver() const {
     return player1GoalDistance == 0 || player2GoalDistance == 0;
 }
 
+// The slack of a player's route is how many extra moves they would need if the first step of their
+// shortest path were blocked, found by comparing the goal distances from each cell they can step to.
+// A player with a single way out of their cell has the maximum slack of BOARD_SIZE.
+int8_t GameState::getPathSlack(std::pair<int8_t, int8_t> playerPosition, int8_t goalY) const {
+    if (playerPosition.second == goalY) {
+        return 0;
+    }
+    int8_t shortest = -1;
+    int8_t secondShortest = -1;
+    for (int8_t i = 0; i < 4; i++) {
+        if (!canMoveDirection(playerPosition.first, playerPosition.second, i)) {
+            continue;
+        }
+        int8_t distance = getGoalDistance({playerPosition.first + DX[i], playerPosition.second + DY[i]}, goalY);
+        if (distance == -1) {
+            continue;
+        }
+        if (shortest == -1 || distance < shortest) {
+            secondShortest = shortest;
+            shortest = distance;
+        } else if (secondShortest == -1 || distance < secondShortest) {
+            secondShortest = distance;
+        }
+    }
+    if (secondShortest == -1) {
+        return BOARD_SIZE;
+    }
+    return std::min<int8_t>(secondShortest - shortest, BOARD_SIZE);
+}
+
+// The mobility of a player is the number of directions they are not blocked from moving in by walls.
+int8_t GameState::getMobility(std::pair<int8_t, int8_t> playerPosition) const {
+    int8_t mobility = 0;
+    for (int8_t i = 0; i < 4; i++) {
+        if (canMoveDirection(playerPosition.first, playerPosition.second, i)) {
+            mobility++;
+        }
+    }
+    return mobility;
+}
+
+EvaluationFeatures GameState::getEvaluationFeatures() const {
+    EvaluationFeatures features;
+    features.goalDistance = player2GoalDistance - player1GoalDistance;
+    features.wallCount = player1WallCount - player2WallCount;
+    features.pathSlack = getPathSlack(player2Position, BOARD_SIZE - 1) - getPathSlack(player1Position, 0);
+    features.mobility = getMobility(player1Position) - getMobility(player2Position);
+    features.turn = isPlayer1sTurn ? 1 : -1;
+    return features;
+}
+
 int16_t GameState::evaluate(int8_t depthRemaining) const {
-    int8_t maxDepth = 3;
     if (player1GoalDistance == 0) {
         // Adjust the score to prefer faster wins and delay losses.
-        return std::numeric_limits<int16_t>::max() - (maxDepth - depthRemaining);
+        return std::numeric_limits<int16_t>::max() - (MAX_SEARCH_DEPTH - depthRemaining);
     }
     if (player2GoalDistance == 0) {
         // Adjust the score to prefer faster wins and delay losses.
-        return std::numeric_limits<int16_t>::min() + (maxDepth - depthRemaining);
+        return std::numeric_limits<int16_t>::min() + (MAX_SEARCH_DEPTH - depthRemaining);
+    }
+    // The weights are compile time constants, so features with a weight of zero are never computed.
+    int16_t score = GOAL_DISTANCE_WEIGHT * (player2GoalDistance - player1GoalDistance);
+    score += WALL_COUNT_WEIGHT * (player1WallCount - player2WallCount);
+    if constexpr (PATH_SLACK_WEIGHT != 0) {
+        score += PATH_SLACK_WEIGHT * (getPathSlack(player2Position, BOARD_SIZE - 1) - getPathSlack(player1Position, 0));
+    }
+    if constexpr (MOBILITY_WEIGHT != 0) {
+        score += MOBILITY_WEIGHT * (getMobility(player1Position) - getMobility(player2Position));
+    }
+    if constexpr (TURN_WEIGHT != 0) {
+        score += TURN_WEIGHT * (isPlayer1sTurn ? 1 : -1);
     }
-    int8_t distanceScore = 5 * (player2GoalDistance - player1GoalDistance);
-    int8_t wallScore = player1WallCount - player2WallCount;
-    return distanceScore + wallScore;
+    return score;
 }
\ No newline at end of file
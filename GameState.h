@@ -3,17 +3,36 @@
 #include <queue>
 #include <array>
 #include <unordered_map>
+#include <vector>
+#include <limits>
 #include "ZobristHash.h"
+#include "EvaluationWeights.h"
 
 // A board is valid if BFS finds paths for both players to their goals.
 // The static evaluation of a board also depends on the lengths of these paths.
 // These distances are cached to avoid calculating them multiple times.
-static std::unordered_map<uint64_t, std::pair<int8_t, int8_t>> goalDistanceCache;
+// Each search thread keeps its own cache, which is cleared once it reaches its size limit.
+// The cache is defined once in GameState.cpp, so clearing it anywhere clears the one the search uses.
+extern thread_local std::unordered_map<uint64_t, std::pair<int8_t, int8_t>> goalDistanceCache;
+constexpr size_t GOAL_DISTANCE_CACHE_LIMIT = 1 << 18;
+
+// Scores of won positions are offset by the distance from the root so that faster wins are preferred.
+// No search may be deeper than this.
+constexpr int8_t MAX_SEARCH_DEPTH = 32;
 
 // Unless blocked, players are able move to adjacent cells (right, up, left, down).
 constexpr int8_t DX[] = {1, 0, -1, 0};
 constexpr int8_t DY[] = {0, 1, 0, -1};
 
+// The terms of the static evaluation, each measured from player 1's perspective.
+struct EvaluationFeatures {
+    int16_t goalDistance;
+    int16_t wallCount;
+    int16_t pathSlack;
+    int16_t mobility;
+    int16_t turn;
+};
+
 struct GameState {
     // There are 64 possible positions for vertical and horizontal walls. 
     // Each position can be represented as a bit in an int64_t.
@@ -30,6 +49,7 @@ struct GameState {
     uint64_t stateHash;
 
     GameState();
+    void computeStateHash();
     int8_t wallBitIndex(int8_t x, int8_t y) const;
     int8_t getGoalDistance(std::pair<int8_t, int8_t> playerPos, int8_t goalY) const;
     void setGoalDistances();
@@ -46,5 +66,8 @@ struct GameState {
     std::vector<std::pair<int8_t, int8_t>> getValidPawnMoves() const;
     std::vector<GameState> getValidMoves() const;
     bool isGameOver() const;
+    int8_t getPathSlack(std::pair<int8_t, int8_t> playerPosition, int8_t goalY) const;
+    int8_t getMobility(std::pair<int8_t, int8_t> playerPosition) const;
+    EvaluationFeatures getEvaluationFeatures() const;
     int16_t evaluate(int8_t depthRemaining) const;
 };
\ No newline at end of file
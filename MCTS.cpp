@@ -1,19 +1,5 @@
 #include <cmath>
-#include "GameState.h"
-
-const double EXPLORATION_CONSTANT = 2.0;
-
-struct MCTSNode {
-    GameState gameState;
-    MCTSNode* parent;
-    std::vector<std::unique_ptr<MCTSNode>> children;
-    int wins;
-    int visits;
-    bool expanded = false;
-
-    MCTSNode(const GameState& gameState, MCTSNode* parent = nullptr) : gameState(gameState),
-                                                                       parent(parent) {}
-};
+#include "MCTS.h"
 
 double ucb1(int simulationCount, int wins, int visits) {
     if (visits == 0) {
@@ -42,4 +28,72 @@ MCTSNode* selectNode(MCTSNode* node) {
         node = bestChild;
     }
     return node;
+}
+
+MCTSNode* expandNode(MCTSNode* node) {
+    if (node->gameState.isGameOver()) {
+        return node;
+    }
+    for (const GameState& child : node->gameState.getValidMoves()) {
+        node->children.push_back(std::make_unique<MCTSNode>(child, node));
+    }
+    node->expanded = true;
+    return node->children.front().get();
+}
+
+// A playout assumes no more walls are placed, so the game becomes a race along both players' shortest paths
+// which is won by the player to move unless their opponent is strictly closer to their goal.
+bool simulate(const GameState& gameState) {
+    if (gameState.isGameOver()) {
+        return gameState.player1GoalDistance == 0;
+    }
+    if (gameState.isPlayer1sTurn) {
+        return gameState.player1GoalDistance <= gameState.player2GoalDistance;
+    }
+    return gameState.player1GoalDistance < gameState.player2GoalDistance;
+}
+
+void backpropagate(MCTSNode* node, bool player1Won) {
+    while (node != nullptr) {
+        node->visits++;
+        if (player1Won == !node->gameState.isPlayer1sTurn) {
+            node->wins++;
+        }
+        node = node->parent;
+    }
+}
+
+// A leaf is expanded the second time it is reached, so that the first playout from each node is cheap.
+void runMCTS(MCTSNode* root, int iterations) {
+    for (int i = 0; i < iterations; i++) {
+        MCTSNode* node = selectNode(root);
+        if (node->visits > 0 && !node->expanded) {
+            node = expandNode(node);
+        }
+        backpropagate(node, simulate(node->gameState));
+    }
+}
+
+MCTSNode* mostVisitedChild(MCTSNode* root) {
+    MCTSNode* bestChild = nullptr;
+    for (std::unique_ptr<MCTSNode>& child : root->children) {
+        if (bestChild == nullptr || child->visits > bestChild->visits) {
+            bestChild = child.get();
+        }
+    }
+    return bestChild;
+}
+
+// After a move is played, the subtree below it becomes the new tree so the playouts already spent on it
+// are kept. Releasing the old root frees every sibling subtree with it.
+void promoteChild(std::unique_ptr<MCTSNode>& root, const GameState& played) {
+    for (std::unique_ptr<MCTSNode>& child : root->children) {
+        if (child->gameState.stateHash == played.stateHash) {
+            std::unique_ptr<MCTSNode> newRoot = std::move(child);
+            newRoot->parent = nullptr;
+            root = std::move(newRoot);
+            return;
+        }
+    }
+    root = std::make_unique<MCTSNode>(played);
 }
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <memory>
+#include "GameState.h"
+
+const double EXPLORATION_CONSTANT = 2.0;
+
+// A node's wins are counted for the player who made the move leading to it.
+struct MCTSNode {
+    GameState gameState;
+    MCTSNode* parent;
+    std::vector<std::unique_ptr<MCTSNode>> children;
+    int wins = 0;
+    int visits = 0;
+    bool expanded = false;
+
+    MCTSNode(const GameState& gameState, MCTSNode* parent = nullptr) : gameState(gameState),
+                                                                       parent(parent) {}
+};
+
+double ucb1(int simulationCount, int wins, int visits);
+MCTSNode* selectNode(MCTSNode* node);
+MCTSNode* expandNode(MCTSNode* node);
+bool simulate(const GameState& gameState);
+void backpropagate(MCTSNode* node, bool player1Won);
+void runMCTS(MCTSNode* root, int iterations);
+MCTSNode* mostVisitedChild(MCTSNode* root);
+void promoteChild(std::unique_ptr<MCTSNode>& root, const GameState& played);
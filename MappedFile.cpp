@@ -0,0 +1,220 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : mappedData(nullptr),
+                           mappedSize(0),
+                           isLocked(false),
+                           wasEmpty(false),
+                           fileHandle(INVALID_HANDLE_VALUE),
+                           mappingHandle(nullptr) {}
+
+bool MappedFile::open(const std::string& path, bool writable, uint64_t minimumSize, bool locked) {
+    close();
+    DWORD access = writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+    DWORD creation = writable ? OPEN_ALWAYS : OPEN_EXISTING;
+    fileHandle = CreateFileA(path.c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, creation, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    if (locked) {
+        // Windows file locks are mandatory, so a single byte far past the end of any file is locked
+        // instead of its contents, leaving the data readable by every process.
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = 0xFFFFFFFF;
+        overlapped.OffsetHigh = 0x7FFFFFFF;
+        if (!LockFileEx(fileHandle, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped)) {
+            close();
+            return false;
+        }
+        isLocked = true;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        close();
+        return false;
+    }
+    uint64_t size = fileSize.QuadPart;
+    wasEmpty = size == 0;
+    if (writable && size == 0 && minimumSize > 0) {
+        LARGE_INTEGER newSize;
+        newSize.QuadPart = minimumSize;
+        if (!SetFilePointerEx(fileHandle, newSize, nullptr, FILE_BEGIN) || !SetEndOfFile(fileHandle)) {
+            close();
+            return false;
+        }
+        size = minimumSize;
+    }
+    // Mapping an empty file is an error on every platform.
+    if (size == 0) {
+        close();
+        return false;
+    }
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        close();
+        return false;
+    }
+    mappedData = static_cast<uint8_t*>(MapViewOfFile(mappingHandle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+    if (mappedData == nullptr) {
+        close();
+        return false;
+    }
+    mappedSize = size;
+    return true;
+}
+
+void MappedFile::unlock() {
+    if (isLocked) {
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = 0xFFFFFFFF;
+        overlapped.OffsetHigh = 0x7FFFFFFF;
+        UnlockFileEx(fileHandle, 0, 1, 0, &overlapped);
+        isLocked = false;
+    }
+}
+
+void MappedFile::close() {
+    unlock();
+    if (mappedData != nullptr) {
+        UnmapViewOfFile(mappedData);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+    }
+    mappedData = nullptr;
+    mappedSize = 0;
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = nullptr;
+}
+
+void MappedFile::flush(uint64_t offset, uint64_t length) {
+    if (mappedData != nullptr) {
+        FlushViewOfFile(mappedData + offset, length);
+    }
+}
+
+void MappedFile::adviseSequential() {}
+
+#else
+
+MappedFile::MappedFile() : mappedData(nullptr),
+                           mappedSize(0),
+                           isLocked(false),
+                           wasEmpty(false),
+                           fileDescriptor(-1) {}
+
+bool MappedFile::open(const std::string& path, bool writable, uint64_t minimumSize, bool locked) {
+    close();
+    fileDescriptor = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (fileDescriptor == -1) {
+        return false;
+    }
+    if (locked) {
+        if (flock(fileDescriptor, LOCK_EX) != 0) {
+            close();
+            return false;
+        }
+        isLocked = true;
+    }
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0) {
+        close();
+        return false;
+    }
+    uint64_t size = fileStatus.st_size;
+    wasEmpty = size == 0;
+    if (writable && size == 0 && minimumSize > 0) {
+        if (ftruncate(fileDescriptor, minimumSize) != 0) {
+            close();
+            return false;
+        }
+        size = minimumSize;
+    }
+    // Mapping an empty file is an error on every platform.
+    if (size == 0) {
+        close();
+        return false;
+    }
+    void* mapping = mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    if (mapping == MAP_FAILED) {
+        close();
+        return false;
+    }
+    mappedData = static_cast<uint8_t*>(mapping);
+    mappedSize = size;
+    return true;
+}
+
+void MappedFile::unlock() {
+    if (isLocked) {
+        flock(fileDescriptor, LOCK_UN);
+        isLocked = false;
+    }
+}
+
+void MappedFile::close() {
+    unlock();
+    if (mappedData != nullptr) {
+        munmap(mappedData, mappedSize);
+    }
+    if (fileDescriptor != -1) {
+        ::close(fileDescriptor);
+    }
+    mappedData = nullptr;
+    mappedSize = 0;
+    fileDescriptor = -1;
+}
+
+// Dirty pages are scheduled for write back without blocking the caller.
+void MappedFile::flush(uint64_t offset, uint64_t length) {
+    if (mappedData == nullptr) {
+        return;
+    }
+    // msync requires a page aligned start address.
+    uint64_t pageSize = sysconf(_SC_PAGESIZE);
+    uint64_t alignedOffset = offset - offset % pageSize;
+    msync(mappedData + alignedOffset, length + (offset - alignedOffset), MS_ASYNC);
+}
+
+void MappedFile::adviseSequential() {
+    if (mappedData != nullptr) {
+        madvise(mappedData, mappedSize, MADV_SEQUENTIAL);
+    }
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::isNew() const {
+    return wasEmpty;
+}
+
+bool MappedFile::isOpen() const {
+    return mappedData != nullptr;
+}
+
+uint8_t* MappedFile::data() const {
+    return mappedData;
+}
+
+uint64_t MappedFile::size() const {
+    return mappedSize;
+}
\ No newline at end of file
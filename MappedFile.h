@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// A file mapped into the address space of the process.
+// Read-only mappings are used to scan game databases without copying them into memory,
+// writable mappings are shared between every process that maps the same file.
+class MappedFile {
+    public:
+        MappedFile();
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // A writable file is created if it does not exist, and grown to minimumSize bytes only if it is empty,
+        // so an existing file is never resized.
+        // If locked is set, the file is locked exclusively before its size is read and stays locked until
+        // unlock or close is called, so that one process at a time can check and initialise its contents.
+        // The lock is advisory: it only excludes other processes that also open the file locked.
+        bool open(const std::string& path, bool writable, uint64_t minimumSize = 0, bool locked = false);
+        void unlock();
+        // True if the file was empty or did not exist when it was opened.
+        bool isNew() const;
+        void close();
+        void flush(uint64_t offset, uint64_t length);
+        void adviseSequential();
+        bool isOpen() const;
+        uint8_t* data() const;
+        uint64_t size() const;
+
+    private:
+        uint8_t* mappedData;
+        uint64_t mappedSize;
+        bool isLocked;
+        bool wasEmpty;
+#ifdef _WIN32
+        void* fileHandle;
+        void* mappingHandle;
+#else
+        int fileDescriptor;
+#endif
+};
\ No newline at end of file
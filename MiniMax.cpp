@@ -1,38 +1,171 @@
 #include "MiniMax.h"
+#include "GameRecord.h"
+#include "PersistentCache.h"
 
-int16_t minimax(const GameState& state, int8_t depth, int16_t alpha, int16_t beta) {
+TranspositionTable transpositionTable(DEFAULT_TRANSPOSITION_TABLE_SIZE);
+
+bool SearchContext::shouldAbort() {
+    // The clock is only read every 1024 nodes, starting with the first, because it is far slower than visiting a node.
+    if (!aborted && (nodes & 1023) == 1) {
+        aborted = (stopRequested != nullptr && stopRequested->load(std::memory_order_relaxed)) ||
+                  std::chrono::steady_clock::now() >= deadline;
+    }
+    return aborted;
+}
+
+// Results are shared through the persistent cache as well as the transposition table, if it is open.
+void storeResult(uint64_t stateHash, int16_t score, int8_t depth, Bound bound, uint8_t move) {
+    transpositionTable.store(stateHash, score, depth, bound, move);
+    persistentCache.store(stateHash, score, depth, bound, move);
+}
+
+// Probes are counted in the search's own context rather than in the shared cache.
+bool probePersistentCache(uint64_t stateHash, TranspositionTableEntry& entry, SearchContext& context) {
+    if (!persistentCache.isOpen()) {
+        return false;
+    }
+    context.persistentCacheStatistics.probes++;
+    bool found = persistentCache.probe(stateHash, entry);
+    context.persistentCacheStatistics.hits += found;
+    return found;
+}
+
+// A stored result settles a position if it was searched deep enough and its bound decides the window.
+bool isCutoff(const TranspositionTableEntry& entry, int8_t depth, int16_t alpha, int16_t beta) {
+    return entry.depth >= depth &&
+           (entry.bound == Bound::Exact ||
+            (entry.bound == Bound::Lower && entry.score >= beta) ||
+            (entry.bound == Bound::Upper && entry.score <= alpha));
+}
+
+// The best move stored for a position, often by the search for a previous move, is searched first
+// because it is the move most likely to cause a cutoff.
+std::vector<GameState> getOrderedMoves(const GameState& state, uint8_t bestMove) {
+    std::vector<GameState> children = state.getValidMoves();
+    if (bestMove == NO_MOVE) {
+        return children;
+    }
+    for (size_t i = 0; i < children.size(); i++) {
+        if (encodeMove(state, children[i]) == bestMove) {
+            std::swap(children[0], children[i]);
+            break;
+        }
+    }
+    return children;
+}
+
+int16_t minimax(const GameState& state, int8_t depth, int16_t alpha, int16_t beta, SearchContext& context) {
+    context.nodes++;
+    if (context.shouldAbort()) {
+        return 0;
+    }
     uint64_t stateHash = state.stateHash;
-    if (transpositionTable.count(stateHash) && transpositionTable[stateHash].depth >= depth) {
-        return transpositionTable[stateHash].score;
+    TranspositionTableEntry entry;
+    uint8_t bestMove = NO_MOVE;
+    if (transpositionTable.probe(stateHash, entry)) {
+        if (isCutoff(entry, depth, alpha, beta)) {
+            return entry.score;
+        }
+        bestMove = entry.move;
+    }
+    // Results in the persistent cache were mostly found by other searches, so they are only used when
+    // they settle the position outright or when the table has no move to search first.
+    // Only results of exactly the requested depth settle it. A deeper score would shift the window
+    // that the cached bounds of its siblings were found with, leaving those bounds unable to cut,
+    // and the same search would return different scores depending on what the cache held.
+    if (depth >= PERSISTENT_CACHE_MIN_DEPTH && probePersistentCache(stateHash, entry, context)) {
+        if (entry.depth == depth && isCutoff(entry, depth, alpha, beta)) {
+            context.persistentCacheStatistics.cutoffs++;
+            transpositionTable.store(stateHash, entry.score, entry.depth, entry.bound, entry.move);
+            return entry.score;
+        }
+        if (bestMove == NO_MOVE) {
+            bestMove = entry.move;
+        }
     }
     if (depth == 0 || state.isGameOver()) {
         int16_t evaluation = state.evaluate(depth);
-        transpositionTable[stateHash] = {evaluation, depth};
+        transpositionTable.store(stateHash, evaluation, depth, Bound::Exact, NO_MOVE);
         return evaluation;
     }
+    int16_t originalAlpha = alpha;
+    int16_t originalBeta = beta;
+    int16_t bestEvaluation;
     if (state.isPlayer1sTurn) {
         int16_t maxEvaluation = std::numeric_limits<int16_t>::min();
-        for (const GameState& child : state.getValidMoves()) {
-            int16_t evaluation = minimax(child, depth - 1, alpha, beta);
-            maxEvaluation = std::max(maxEvaluation, evaluation);
+        for (const GameState& child : getOrderedMoves(state, bestMove)) {
+            int16_t evaluation = minimax(child, depth - 1, alpha, beta, context);
+            if (evaluation > maxEvaluation) {
+                maxEvaluation = evaluation;
+                bestMove = encodeMove(state, child);
+            }
             alpha = std::max(alpha, evaluation);
             if (beta <= alpha) {
                 break;
             }
         }
-        transpositionTable[stateHash] = {maxEvaluation, depth};
-        return maxEvaluation;
+        bestEvaluation = maxEvaluation;
     } else {
         int16_t minEvaluation = std::numeric_limits<int16_t>::max();
-        for (const GameState& child : state.getValidMoves()) {
-            int16_t evaluation = minimax(child, depth - 1, alpha, beta);
-            minEvaluation = std::min(minEvaluation, evaluation);
+        for (const GameState& child : getOrderedMoves(state, bestMove)) {
+            int16_t evaluation = minimax(child, depth - 1, alpha, beta, context);
+            if (evaluation < minEvaluation) {
+                minEvaluation = evaluation;
+                bestMove = encodeMove(state, child);
+            }
             beta = std::min(beta, evaluation);
             if (beta <= alpha) {
                 break;
             }
         }
-        transpositionTable[stateHash] = {minEvaluation, depth};
-        return minEvaluation;
+        bestEvaluation = minEvaluation;
+    }
+    // A search that was stopped part way through must not leave its partial score in the table.
+    if (!context.aborted) {
+        // When every move failed low none of them is known to be best, so no move is stored to be searched first.
+        Bound bound = bestEvaluation <= originalAlpha ? Bound::Upper : bestEvaluation >= originalBeta ? Bound::Lower : Bound::Exact;
+        storeResult(stateHash, bestEvaluation, depth, bound, bound == Bound::Upper ? NO_MOVE : bestMove);
+    }
+    return bestEvaluation;
+}
+
+// Player 1 maximises the evaluation and player 2 minimises it.
+// If the search is aborted the best move among the children searched so far is returned.
+SearchResult searchRoot(const GameState& state, int8_t depth, SearchContext& context) {
+    TranspositionTableEntry entry;
+    uint8_t bestMove = transpositionTable.probe(state.stateHash, entry) ? entry.move : NO_MOVE;
+    if (bestMove == NO_MOVE && probePersistentCache(state.stateHash, entry, context)) {
+        bestMove = entry.move;
+    }
+    const std::vector<GameState> children = getOrderedMoves(state, bestMove);
+    SearchResult result = {children.front(), state.isPlayer1sTurn ? std::numeric_limits<int16_t>::min() : std::numeric_limits<int16_t>::max()};
+    int16_t alpha = std::numeric_limits<int16_t>::min();
+    int16_t beta = std::numeric_limits<int16_t>::max();
+    float completed = 0.0f;
+    for (const GameState& child : children) {
+        int16_t evaluation = minimax(child, depth - 1, alpha, beta, context);
+        if (context.aborted) {
+            break;
+        }
+        if (state.isPlayer1sTurn && evaluation > result.score) {
+            result = {child, evaluation};
+            alpha = evaluation;
+        } else if (!state.isPlayer1sTurn && evaluation < result.score) {
+            result = {child, evaluation};
+            beta = evaluation;
+        }
+        completed++;
+        if (context.progress != nullptr) {
+            *context.progress = completed / children.size();
+        }
+    }
+    if (!context.aborted) {
+        storeResult(state.stateHash, result.score, depth, Bound::Exact, encodeMove(state, result.bestMove));
+    }
+    if (context.progress != nullptr) {
+        *context.progress = 0.0f;
     }
-}
\ No newline at end of file
+    persistentCache.addStatistics(context.persistentCacheStatistics);
+    context.persistentCacheStatistics = {};
+    return result;
+}
@@ -1,11 +1,33 @@
 #pragma once
 
-#include "GameState.h"
+#include <atomic>
+#include <chrono>
+#include "PersistentCache.h"
+#include "TranspositionTable.h"
 
-struct TranspositionTableEntry {
-    int score;
-    int depth;
+// The table is kept between moves so that each search can reuse the results of the last one.
+// transpositionTable.newSearch() should be called once before searching for each move.
+extern TranspositionTable transpositionTable;
+
+// The limits and statistics of a single search.
+// A search stops early once stopRequested is set or the deadline passes,
+// in which case aborted is set and the scores it returned must be discarded.
+struct SearchContext {
+    const std::atomic<bool>* stopRequested = nullptr;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    std::atomic<float>* progress = nullptr;
+    uint64_t nodes = 0;
+    // Persistent cache probes not yet added to the cache's totals, which searchRoot does when it returns.
+    PersistentCacheStatistics persistentCacheStatistics;
+    bool aborted = false;
+
+    bool shouldAbort();
+};
+
+struct SearchResult {
+    GameState bestMove;
+    int16_t score;
 };
-static std::unordered_map<uint64_t, TranspositionTableEntry> transpositionTable;
 
-int16_t minimax(const GameState& state, int8_t depth, int16_t alpha, int16_t beta);
\ No newline at end of file
+int16_t minimax(const GameState& state, int8_t depth, int16_t alpha, int16_t beta, SearchContext& context);
+SearchResult searchRoot(const GameState& state, int8_t depth, SearchContext& context);
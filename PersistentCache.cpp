@@ -0,0 +1,151 @@
+#include <cstring>
+#include "PersistentCache.h"
+
+PersistentCache persistentCache;
+
+namespace {
+    const size_t HEADER_SIZE = 64;
+    const uint32_t PERSISTENT_CACHE_VERSION = 1;
+
+    // Processes only share slots through atomics if those atomics are plain 64 bit values in the file.
+    static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) && std::atomic<uint64_t>::is_always_lock_free,
+                  "Persistent cache slots must be lock free 64 bit atomics");
+
+    uint64_t mixSignature(uint64_t signature, uint64_t value) {
+        return (signature ^ value) * 1099511628211ull;
+    }
+
+    // Scores depend on the evaluation weights and the win score offsets, and entries are found by
+    // Zobrist hash, so the signature covers all of them. The Zobrist keys are drawn by the standard
+    // library's uniform_int_distribution, which may differ between toolchains.
+    uint64_t evaluationSignature() {
+        const int64_t values[] = {GOAL_DISTANCE_WEIGHT, WALL_COUNT_WEIGHT, PATH_SLACK_WEIGHT, MOBILITY_WEIGHT, TURN_WEIGHT, MAX_SEARCH_DEPTH};
+        uint64_t signature = 14695981039346656037ull;
+        for (int64_t value : values) {
+            signature = mixSignature(signature, static_cast<uint64_t>(value));
+        }
+        static_assert(sizeof(ZobristHash) % sizeof(uint64_t) == 0, "Zobrist keys must be 64 bit values without padding");
+        const ZobristHash zobristHash;
+        const uint64_t* keys = reinterpret_cast<const uint64_t*>(&zobristHash);
+        for (size_t i = 0; i < sizeof(ZobristHash) / sizeof(uint64_t); i++) {
+            signature = mixSignature(signature, keys[i]);
+        }
+        return signature;
+    }
+
+    struct CacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t slotCount;
+        uint64_t signature;
+    };
+}
+
+PersistentCache::PersistentCache() : slots(nullptr),
+                                     mask(0),
+                                     probeCount(0),
+                                     hitCount(0),
+                                     cutoffCount(0),
+                                     storeCount(0) {}
+
+// The header is checked and, for a new file, written while the file is locked, so two processes
+// opening a new cache at once cannot both initialise it. Only a file that was empty is grown and
+// initialised; any other file without a matching header is left exactly as it was.
+bool PersistentCache::open(const std::string& path, size_t entryCount) {
+    close();
+    size_t slotCount = 1;
+    while (slotCount * 2 <= entryCount) {
+        slotCount *= 2;
+    }
+    if (!file.open(path, true, HEADER_SIZE + slotCount * 16, true)) {
+        return false;
+    }
+    if (file.isNew()) {
+        // A file grown from empty is already zeroed, so only the header has to be written.
+        CacheHeader header = {{'Q', 'P', 'C', 'C'}, PERSISTENT_CACHE_VERSION, slotCount, evaluationSignature()};
+        std::memcpy(file.data(), &header, sizeof(header));
+        file.flush(0, HEADER_SIZE);
+    } else {
+        // A file written by another version, with other evaluation weights or Zobrist keys, or by
+        // something else entirely is refused, since the engine that wrote it may still be using it.
+        CacheHeader header;
+        bool isCompatible = file.size() >= HEADER_SIZE;
+        if (isCompatible) {
+            std::memcpy(&header, file.data(), sizeof(header));
+            isCompatible = std::memcmp(header.magic, "QPCC", 4) == 0 &&
+                           header.version == PERSISTENT_CACHE_VERSION &&
+                           header.signature == evaluationSignature() &&
+                           header.slotCount != 0 && (header.slotCount & (header.slotCount - 1)) == 0 &&
+                           header.slotCount <= (file.size() - HEADER_SIZE) / 16;
+        }
+        if (!isCompatible) {
+            file.close();
+            return false;
+        }
+        slotCount = header.slotCount;
+    }
+    file.unlock();
+    slots = reinterpret_cast<std::atomic<uint64_t>*>(file.data() + HEADER_SIZE);
+    mask = slotCount - 1;
+    return true;
+}
+
+void PersistentCache::close() {
+    if (file.isOpen()) {
+        flush();
+    }
+    file.close();
+    slots = nullptr;
+    mask = 0;
+}
+
+bool PersistentCache::isOpen() const {
+    return slots != nullptr;
+}
+
+bool PersistentCache::probe(uint64_t stateHash, TranspositionTableEntry& entry) {
+    if (slots == nullptr) {
+        return false;
+    }
+    std::atomic<uint64_t>* slot = slots + 2 * (stateHash & mask);
+    uint64_t data = slot[1].load(std::memory_order_relaxed);
+    if (data == 0 || (slot[0].load(std::memory_order_relaxed) ^ data) != stateHash) {
+        return false;
+    }
+    entry = unpackEntry(data);
+    return true;
+}
+
+// Deeper results are kept in preference to shallower ones, whichever process found them.
+void PersistentCache::store(uint64_t stateHash, int16_t score, int8_t depth, Bound bound, uint8_t move) {
+    if (slots == nullptr || depth < PERSISTENT_CACHE_MIN_DEPTH) {
+        return;
+    }
+    std::atomic<uint64_t>* slot = slots + 2 * (stateHash & mask);
+    uint64_t existingData = slot[1].load(std::memory_order_relaxed);
+    if (existingData != 0 && unpackEntry(existingData).depth > depth) {
+        return;
+    }
+    uint64_t data = packEntry({score, depth, bound, move, 0});
+    slot[0].store(stateHash ^ data, std::memory_order_relaxed);
+    slot[1].store(data, std::memory_order_relaxed);
+    if (storeCount.fetch_add(1, std::memory_order_relaxed) % PERSISTENT_CACHE_FLUSH_INTERVAL == PERSISTENT_CACHE_FLUSH_INTERVAL - 1) {
+        flush();
+    }
+}
+
+void PersistentCache::flush() {
+    file.flush(0, file.size());
+}
+
+void PersistentCache::addStatistics(const PersistentCacheStatistics& statistics) {
+    probeCount.fetch_add(statistics.probes, std::memory_order_relaxed);
+    hitCount.fetch_add(statistics.hits, std::memory_order_relaxed);
+    cutoffCount.fetch_add(statistics.cutoffs, std::memory_order_relaxed);
+}
+
+PersistentCacheStatistics PersistentCache::getStatistics() const {
+    return {probeCount.load(std::memory_order_relaxed),
+            hitCount.load(std::memory_order_relaxed),
+            cutoffCount.load(std::memory_order_relaxed)};
+}
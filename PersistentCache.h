@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "MappedFile.h"
+#include "TranspositionTable.h"
+
+// A hit may only supply a move to search first. Hits that settle a position and save its search
+// are counted separately as cutoffs.
+struct PersistentCacheStatistics {
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    uint64_t cutoffs = 0;
+};
+
+// An optional second level of the transposition table that outlives the process.
+// The file is memory mapped, so opening it costs the same however many entries it holds,
+// and several engine processes on one host can map the same file and share their results.
+// Slots use the same lockless layout as the transposition table, which keeps concurrent
+// writes from different processes safe.
+//
+// The file starts with a 64 byte header holding the magic bytes "QPCC", the format version,
+// the number of slots and a signature of the evaluation weights and Zobrist keys, followed by 16 byte slots.
+// The header is checked and written while the file is locked. A file written with different weights or
+// keys is refused when it is opened, since its entries do not apply and its engine may still be using it.
+//
+// Only results searched at least PERSISTENT_CACHE_MIN_DEPTH plies deep are kept. Shallower results
+// are cheaper to recompute than to share, and would displace the deep results worth keeping.
+class PersistentCache {
+    public:
+        PersistentCache();
+
+        // Opens or creates the cache. A new cache holds entryCount slots rounded down to a power of two,
+        // an existing cache keeps its own size. Returns false if the file cannot be mapped, is not a cache,
+        // or was written by another version of the cache or with other evaluation weights or Zobrist keys.
+        bool open(const std::string& path, size_t entryCount);
+        void close();
+        bool isOpen() const;
+        bool probe(uint64_t stateHash, TranspositionTableEntry& entry);
+        void store(uint64_t stateHash, int16_t score, int8_t depth, Bound bound, uint8_t move);
+        // Dirty pages are written back in the background every PERSISTENT_CACHE_FLUSH_INTERVAL stores.
+        void flush();
+        // Searches count their own probes and add them here once per search, so that concurrent
+        // searches do not contend on the counters at every node.
+        void addStatistics(const PersistentCacheStatistics& statistics);
+        PersistentCacheStatistics getStatistics() const;
+
+    private:
+        MappedFile file;
+        std::atomic<uint64_t>* slots;
+        size_t mask;
+        std::atomic<uint64_t> probeCount;
+        std::atomic<uint64_t> hitCount;
+        std::atomic<uint64_t> cutoffCount;
+        // Shared by every search so that the cache is flushed every PERSISTENT_CACHE_FLUSH_INTERVAL stores in total.
+        std::atomic<uint64_t> storeCount;
+};
+
+constexpr int8_t PERSISTENT_CACHE_MIN_DEPTH = 2;
+constexpr uint64_t PERSISTENT_CACHE_FLUSH_INTERVAL = 1 << 16;
+// 2^22 slots of 16 bytes each occupy 64 MiB.
+constexpr size_t DEFAULT_PERSISTENT_CACHE_SIZE = 1 << 22;
+
+extern PersistentCache persistentCache;
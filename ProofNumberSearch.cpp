@@ -0,0 +1,234 @@
+#include <algorithm>
+#include "ProofNumberSearch.h"
+#include "GameRecord.h"
+
+namespace {
+    // Proof and disproof numbers saturate at INFINITE_PROOF, which marks a node as disproven or proven respectively.
+    const uint32_t INFINITE_PROOF = 1u << 30;
+
+    struct ProofEntry {
+        uint64_t stateHash;
+        uint32_t proofNumber;
+        uint32_t disproofNumber;
+        // The attacker's move that proves the position, once it is proven.
+        uint8_t move;
+    };
+
+    uint32_t saturatingAdd(uint32_t a, uint32_t b) {
+        return std::min(a + b, INFINITE_PROOF);
+    }
+
+    class ProofNumberSearch {
+        public:
+            ProofNumberSearch(const GameState& root, size_t memoryBudget, uint64_t nodeLimit, SearchContext& context);
+
+            ProofResult solve();
+
+        private:
+            std::vector<ProofEntry> table;
+            const GameState& root;
+            bool attackerIsPlayer1;
+            uint64_t nodeLimit;
+            SearchContext& context;
+            uint64_t startNodes;
+
+            ProofEntry lookup(const GameState& state) const;
+            ProofEntry* findSlot(uint64_t stateHash);
+            void store(const GameState& state, uint32_t proofNumber, uint32_t disproofNumber, uint8_t move);
+            bool isOrNode(const GameState& state) const;
+            std::vector<GameState> getChildren(const GameState& state) const;
+            ProofEntry search(const GameState& state, uint32_t proofThreshold, uint32_t disproofThreshold);
+    };
+
+    ProofNumberSearch::ProofNumberSearch(const GameState& root, size_t memoryBudget, uint64_t nodeLimit, SearchContext& context) :
+        table(std::max<size_t>(1, memoryBudget / sizeof(ProofEntry) / 2) * 2, {0, 1, 1, NO_MOVE}),
+        root(root),
+        attackerIsPlayer1(root.isPlayer1sTurn),
+        nodeLimit(nodeLimit),
+        context(context),
+        startNodes(context.nodes) {}
+
+    // Positions missing from the table, including those overwritten when the table is full, are unexplored.
+    // Their proof number starts as the attacker's goal distance and their disproof number as the defender's,
+    // so the search first follows the moves that bring the attacker closest to their goal.
+    ProofEntry ProofNumberSearch::lookup(const GameState& state) const {
+        if (state.isGameOver()) {
+            bool attackerWon = attackerIsPlayer1 ? state.player1GoalDistance == 0 : state.player2GoalDistance == 0;
+            return {state.stateHash, attackerWon ? 0 : INFINITE_PROOF, attackerWon ? INFINITE_PROOF : 0, NO_MOVE};
+        }
+        size_t bucket = state.stateHash % (table.size() / 2) * 2;
+        for (size_t i = bucket; i < bucket + 2; i++) {
+            if (table[i].stateHash == state.stateHash) {
+                return table[i];
+            }
+        }
+        int8_t attackerDistance = attackerIsPlayer1 ? state.player1GoalDistance : state.player2GoalDistance;
+        int8_t defenderDistance = attackerIsPlayer1 ? state.player2GoalDistance : state.player1GoalDistance;
+        return {state.stateHash, static_cast<uint32_t>(attackerDistance), static_cast<uint32_t>(defenderDistance), NO_MOVE};
+    }
+
+    // Each position may be stored in either slot of a two slot bucket. A position already in the bucket is
+    // updated in place, and otherwise an unsolved entry is replaced in preference to a solved one.
+    // An unsolved position is only dropped if both slots hold solved positions, which costs nothing but
+    // a repeated search since the parent keeps the numbers its children return.
+    ProofEntry* ProofNumberSearch::findSlot(uint64_t stateHash) {
+        size_t bucket = stateHash % (table.size() / 2) * 2;
+        ProofEntry* unsolvedSlot = nullptr;
+        for (size_t i = bucket; i < bucket + 2; i++) {
+            if (table[i].stateHash == stateHash) {
+                return &table[i];
+            }
+            if (unsolvedSlot == nullptr && table[i].proofNumber != 0 && table[i].disproofNumber != 0) {
+                unsolvedSlot = &table[i];
+            }
+        }
+        return unsolvedSlot;
+    }
+
+    void ProofNumberSearch::store(const GameState& state, uint32_t proofNumber, uint32_t disproofNumber, uint8_t move) {
+        ProofEntry* slot = findSlot(state.stateHash);
+        if (slot == nullptr) {
+            if (proofNumber != 0 && disproofNumber != 0) {
+                return;
+            }
+            // Both slots are solved, so the newer result replaces the first of them.
+            slot = &table[state.stateHash % (table.size() / 2) * 2];
+        }
+        *slot = {state.stateHash, proofNumber, disproofNumber, move};
+    }
+
+    bool ProofNumberSearch::isOrNode(const GameState& state) const {
+        return state.isPlayer1sTurn == attackerIsPlayer1;
+    }
+
+    // The attacker only moves closer to their goal, and each defender wall can be placed only once,
+    // so no position can repeat and the search never has to deal with cycles.
+    std::vector<GameState> ProofNumberSearch::getChildren(const GameState& state) const {
+        if (!isOrNode(state)) {
+            return state.getValidMoves();
+        }
+        int8_t attackerDistance = attackerIsPlayer1 ? state.player1GoalDistance : state.player2GoalDistance;
+        std::vector<GameState> children;
+        for (const std::pair<int8_t, int8_t>& pawnMove : state.getValidPawnMoves()) {
+            GameState child = state;
+            child.movePawn(pawnMove.first, pawnMove.second);
+            if ((attackerIsPlayer1 ? child.player1GoalDistance : child.player2GoalDistance) < attackerDistance) {
+                children.push_back(child);
+            }
+        }
+        return children;
+    }
+
+    // At an OR node the attacker needs one child to be proven, so its proof number is the smallest of its
+    // children's and its disproof number their sum. An AND node is the reverse. The most proving child is
+    // searched until the node's numbers reach their thresholds, with thresholds that return control here
+    // as soon as another child becomes more proving.
+    // The children's numbers are kept locally and updated from what each child's search returns, so the
+    // search keeps making progress even when a child's result is lost from the table.
+    ProofEntry ProofNumberSearch::search(const GameState& state, uint32_t proofThreshold, uint32_t disproofThreshold) {
+        context.nodes++;
+        std::vector<GameState> children = getChildren(state);
+        std::vector<ProofEntry> childEntries;
+        childEntries.reserve(children.size());
+        for (const GameState& child : children) {
+            childEntries.push_back(lookup(child));
+        }
+        bool isOr = isOrNode(state);
+        uint32_t proofNumber = 0;
+        uint32_t disproofNumber = 0;
+        uint8_t provingMove = NO_MOVE;
+        while (true) {
+            size_t bestChild = 0;
+            uint32_t best = INFINITE_PROOF;
+            uint32_t secondBest = INFINITE_PROOF;
+            uint32_t bestChildProof = 0;
+            uint32_t bestChildDisproof = 0;
+            uint32_t sum = 0;
+            for (size_t i = 0; i < children.size(); i++) {
+                const ProofEntry& child = childEntries[i];
+                uint32_t minimised = isOr ? child.proofNumber : child.disproofNumber;
+                sum = saturatingAdd(sum, isOr ? child.disproofNumber : child.proofNumber);
+                if (minimised < best) {
+                    secondBest = best;
+                    best = minimised;
+                    bestChild = i;
+                    bestChildProof = child.proofNumber;
+                    bestChildDisproof = child.disproofNumber;
+                } else if (minimised < secondBest) {
+                    secondBest = minimised;
+                }
+            }
+            proofNumber = isOr ? best : sum;
+            disproofNumber = isOr ? sum : best;
+            if (isOr && proofNumber == 0) {
+                provingMove = encodeMove(state, children[bestChild]);
+            }
+            if (proofNumber >= proofThreshold || disproofNumber >= disproofThreshold ||
+                context.nodes - startNodes >= nodeLimit || context.shouldAbort()) {
+                break;
+            }
+            if (isOr) {
+                childEntries[bestChild] = search(children[bestChild], std::min(proofThreshold, saturatingAdd(secondBest, 1)),
+                                                 saturatingAdd(disproofThreshold - disproofNumber, bestChildDisproof));
+            } else {
+                childEntries[bestChild] = search(children[bestChild], saturatingAdd(proofThreshold - proofNumber, bestChildProof),
+                                                 std::min(disproofThreshold, saturatingAdd(secondBest, 1)));
+            }
+        }
+        if (!context.aborted) {
+            store(state, proofNumber, disproofNumber, provingMove);
+        }
+        return {state.stateHash, proofNumber, disproofNumber, provingMove};
+    }
+
+    // The winning line follows the proving move at the attacker's turns and, at the defender's turns,
+    // the proven reply that leaves the defender closest to their own goal.
+    ProofResult ProofNumberSearch::solve() {
+        ProofResult result = {search(root, INFINITE_PROOF, INFINITE_PROOF).proofNumber == 0, {}};
+        if (!result.proven) {
+            return result;
+        }
+        GameState state = root;
+        while (!state.isGameOver()) {
+            GameState next;
+            if (isOrNode(state)) {
+                uint8_t move = lookup(state).move;
+                if (move == NO_MOVE) {
+                    break;
+                }
+                next = state;
+                applyMove(next, move);
+            } else {
+                int8_t bestDistance = std::numeric_limits<int8_t>::max();
+                for (const GameState& child : state.getValidMoves()) {
+                    int8_t distance = attackerIsPlayer1 ? child.player2GoalDistance : child.player1GoalDistance;
+                    if (lookup(child).proofNumber == 0 && distance < bestDistance) {
+                        bestDistance = distance;
+                        next = child;
+                    }
+                }
+                if (bestDistance == std::numeric_limits<int8_t>::max()) {
+                    break;
+                }
+            }
+            result.winningLine.push_back(encodeMove(state, next));
+            state = next;
+        }
+        result.proven = !result.winningLine.empty();
+        return result;
+    }
+}
+
+bool isRacePosition(const GameState& state) {
+    int8_t attackerDistance = state.isPlayer1sTurn ? state.player1GoalDistance : state.player2GoalDistance;
+    int8_t defenderDistance = state.isPlayer1sTurn ? state.player2GoalDistance : state.player1GoalDistance;
+    int8_t defenderWalls = state.isPlayer1sTurn ? state.player2WallCount : state.player1WallCount;
+    return !state.isGameOver() &&
+           defenderWalls <= RACE_WALL_LIMIT &&
+           attackerDistance <= RACE_DISTANCE_LIMIT &&
+           attackerDistance <= defenderDistance;
+}
+
+ProofResult solveRace(const GameState& state, size_t memoryBudget, uint64_t nodeLimit, SearchContext& context) {
+    return ProofNumberSearch(state, memoryBudget, nodeLimit, context).solve();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "MiniMax.h"
+
+// Late in a game a pawn race can be a forced win for the player to move long before the win is within
+// the minimax search depth. Depth first proof number search (df-pn) looks for such a win without a
+// depth limit, bounded instead by a node limit and the memory given to its own transposition table.
+//
+// Only the player to move's pawn moves towards their goal are considered when looking for their win, while
+// every move of their opponent, including walls, is considered when checking the win cannot be stopped.
+// A proof is therefore always sound, but wins that need the attacking player to place walls or step
+// away from their goal are left to minimax.
+
+// A race is only attempted when the opponent has few walls left to block with and
+// the player to move is no further from their goal.
+constexpr int8_t RACE_WALL_LIMIT = 2;
+constexpr int8_t RACE_DISTANCE_LIMIT = 8;
+constexpr size_t DEFAULT_PROOF_MEMORY_BUDGET = 16 << 20;
+constexpr uint64_t DEFAULT_PROOF_NODE_LIMIT = 20000;
+// The GUI and the server try a proof before every move they search, so a race that cannot be proven
+// must not delay the move noticeably or use up the time given to the search that follows.
+constexpr std::chrono::milliseconds PROOF_TIME_LIMIT(200);
+
+struct ProofResult {
+    bool proven;
+    // The moves of the proven win, encoded as in GameRecord.h, starting with the move to play now.
+    std::vector<uint8_t> winningLine;
+};
+
+bool isRacePosition(const GameState& state);
+ProofResult solveRace(const GameState& state, size_t memoryBudget, uint64_t nodeLimit, SearchContext& context);
@@ -1,25 +1,27 @@
 #include <iostream>
 #include <thread>
 #include "MiniMax.h"
+#include "ProofNumberSearch.h"
+#include "GameRecord.h"
 #include "BoardGui.h"
 #include "AIProgressBar.h"
 
 GameState findBestMove(const GameState& state, int8_t depth, AIProgressBar& aiProgressBar) {
-    const std::vector<GameState> children = state.getValidMoves();
-    int16_t minEvaluation = std::numeric_limits<int16_t>::max();
-    GameState bestMove;
-    float completed = 0.0f;
-    for (const GameState& child : children) {
-        int16_t evaluation = minimax(child, depth - 1, std::numeric_limits<int16_t>::min(), minEvaluation);
-        if (evaluation < minEvaluation) {
-            minEvaluation = evaluation;
-            bestMove = child;
+    // A proven win in a race overrides the depth limited search.
+    if (isRacePosition(state)) {
+        SearchContext proofContext;
+        proofContext.deadline = std::chrono::steady_clock::now() + PROOF_TIME_LIMIT;
+        ProofResult proof = solveRace(state, DEFAULT_PROOF_MEMORY_BUDGET, DEFAULT_PROOF_NODE_LIMIT, proofContext);
+        if (proof.proven) {
+            GameState bestMove = state;
+            applyMove(bestMove, proof.winningLine.front());
+            return bestMove;
         }
-        completed++;
-        aiProgressBar.progress = completed / children.size();
     }
-    aiProgressBar.progress = 0.0f;
-    return bestMove;
+    transpositionTable.newSearch();
+    SearchContext context;
+    context.progress = &aiProgressBar.progress;
+    return searchRoot(state, depth, context).bestMove;
 }
 
 void playGameSFML() {
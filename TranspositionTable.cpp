@@ -0,0 +1,80 @@
+#include "TranspositionTable.h"
+
+uint64_t packEntry(const TranspositionTableEntry& entry) {
+    return static_cast<uint16_t>(entry.score) |
+           static_cast<uint64_t>(static_cast<uint8_t>(entry.depth)) << 16 |
+           static_cast<uint64_t>(entry.move) << 24 |
+           static_cast<uint64_t>(entry.bound) << 32 |
+           static_cast<uint64_t>(entry.generation) << 40;
+}
+
+TranspositionTableEntry unpackEntry(uint64_t data) {
+    TranspositionTableEntry entry;
+    entry.score = static_cast<int16_t>(data & 0xFFFF);
+    entry.depth = static_cast<int8_t>((data >> 16) & 0xFF);
+    entry.move = static_cast<uint8_t>((data >> 24) & 0xFF);
+    entry.bound = static_cast<Bound>((data >> 32) & 0x3);
+    entry.generation = static_cast<uint8_t>((data >> 40) & 0xFF);
+    return entry;
+}
+
+TranspositionTable::TranspositionTable(size_t entryCount) : generation(0) {
+    resize(entryCount);
+}
+
+void TranspositionTable::resize(size_t entryCount) {
+    size_t slotCount = 1;
+    while (slotCount * 2 <= entryCount) {
+        slotCount *= 2;
+    }
+    slots.reset(new Slot[slotCount]);
+    mask = slotCount - 1;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= mask; i++) {
+        slots[i].keyXorData.store(0, std::memory_order_relaxed);
+        slots[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+// The generation is an 8 bit counter, so it wraps around after 256 searches.
+// Entries that old are treated as current, which only affects which entries are replaced.
+// A process playing one game calls this once per move; a process interleaving many games
+// should advance it on a timer instead, as EngineServer does.
+void TranspositionTable::newSearch() {
+    generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint8_t TranspositionTable::getGeneration() const {
+    return generation.load(std::memory_order_relaxed);
+}
+
+bool TranspositionTable::probe(uint64_t stateHash, TranspositionTableEntry& entry) const {
+    const Slot& slot = slots[stateHash & mask];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    if ((slot.keyXorData.load(std::memory_order_relaxed) ^ data) != stateHash) {
+        return false;
+    }
+    entry = unpackEntry(data);
+    return true;
+}
+
+void TranspositionTable::store(uint64_t stateHash, int16_t score, int8_t depth, Bound bound, uint8_t move) {
+    Slot& slot = slots[stateHash & mask];
+    uint64_t existingData = slot.data.load(std::memory_order_relaxed);
+    bool isSamePosition = (slot.keyXorData.load(std::memory_order_relaxed) ^ existingData) == stateHash;
+    TranspositionTableEntry existing = unpackEntry(existingData);
+    uint8_t currentGeneration = getGeneration();
+    if (!isSamePosition && existingData != 0 && existing.generation == currentGeneration && existing.depth > depth) {
+        return;
+    }
+    uint64_t data = packEntry({score, depth, bound, move, currentGeneration});
+    slot.keyXorData.store(stateHash ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+size_t TranspositionTable::size() const {
+    return mask + 1;
+}
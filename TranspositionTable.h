@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "GameState.h"
+
+// Scores found inside a narrowed alpha-beta window are only bounds on a position's true score.
+enum class Bound : uint8_t {
+    Exact,
+    Lower,
+    Upper
+};
+
+struct TranspositionTableEntry {
+    int16_t score;
+    int8_t depth;
+    Bound bound;
+    // The best move found, encoded as in GameRecord.h, or NO_MOVE.
+    uint8_t move;
+    // The search that stored the entry, see TranspositionTable::newSearch.
+    uint8_t generation;
+};
+
+// Bits 0-15 hold the score, 16-23 the depth, 24-31 the move, 32-33 the bound and 40-47 the generation.
+uint64_t packEntry(const TranspositionTableEntry& entry);
+TranspositionTableEntry unpackEntry(uint64_t data);
+
+// A fixed size hash table shared by every search thread.
+// Each slot stores its entry packed into 64 bits alongside the state hash XORed with that data,
+// so a slot torn by two threads writing at once fails verification instead of returning
+// another position's score.
+// Entries survive from one move to the next so later searches can reuse them. Every search
+// starts a new generation, and an entry from an earlier generation can be replaced by any new
+// entry, while an entry from the current generation is only replaced by one searched at least as deep.
+class TranspositionTable {
+    public:
+        TranspositionTable(size_t entryCount);
+
+        // The entry count is rounded down to a power of two and the table is cleared.
+        void resize(size_t entryCount);
+        void clear();
+        void newSearch();
+        uint8_t getGeneration() const;
+        bool probe(uint64_t stateHash, TranspositionTableEntry& entry) const;
+        void store(uint64_t stateHash, int16_t score, int8_t depth, Bound bound, uint8_t move);
+        size_t size() const;
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> keyXorData;
+            std::atomic<uint64_t> data;
+        };
+        std::unique_ptr<Slot[]> slots;
+        size_t mask;
+        std::atomic<uint8_t> generation;
+};
+
+// 2^20 slots of 16 bytes each occupy 16 MiB.
+constexpr size_t DEFAULT_TRANSPOSITION_TABLE_SIZE = 1 << 20;
@@ -0,0 +1,46 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(size_t threadCount) : stopping(false) {
+    for (size_t i = 0; i < threadCount; i++) {
+        threads.emplace_back(&WorkerPool::run, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push(std::move(job));
+    }
+    jobAvailable.notify_one();
+}
+
+size_t WorkerPool::getThreadCount() const {
+    return threads.size();
+}
+
+void WorkerPool::run() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop();
+        }
+        job();
+    }
+}
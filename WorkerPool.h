@@ -0,0 +1,28 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// A fixed set of threads that run submitted jobs in the order they were submitted.
+// Jobs still queued when the pool is destroyed are run before its threads are joined.
+class WorkerPool {
+    public:
+        WorkerPool(size_t threadCount);
+        ~WorkerPool();
+
+        void submit(std::function<void()> job);
+        size_t getThreadCount() const;
+
+    private:
+        std::vector<std::thread> threads;
+        std::queue<std::function<void()>> jobs;
+        std::mutex mutex;
+        std::condition_variable jobAvailable;
+        bool stopping;
+
+        void run();
+};
@@ -0,0 +1,131 @@
+// Writes a game database of randomly played games, checks that every game survives the round trip
+// through the compact encoding, and measures how quickly the database can be scanned.
+// Usage: GameDatabaseBenchmark [path] [game count]
+#include <chrono>
+#include <iostream>
+#include <random>
+#include "../GameRecord.h"
+
+const int DISTINCT_GAME_COUNT = 1000;
+const int MAX_GAME_LENGTH = 200;
+
+struct RecordedGame {
+    GameState startState;
+    std::vector<uint8_t> moves;
+    int8_t result;
+    uint64_t finalStateHash;
+};
+
+// Players mostly step along their shortest path and occasionally place a random wall,
+// which produces games with a realistic mix of pawn moves and walls.
+RecordedGame playRandomGame(std::mt19937& randomGenerator) {
+    std::uniform_real_distribution<double> probability(0.0, 1.0);
+    RecordedGame game;
+    GameState state = game.startState;
+    while (!state.isGameOver() && game.moves.size() < MAX_GAME_LENGTH) {
+        int8_t playerWalls = state.isPlayer1sTurn ? state.player1WallCount : state.player2WallCount;
+        std::vector<GameState> children;
+        if (playerWalls > 0 && probability(randomGenerator) < 0.15) {
+            children = state.getValidMoves();
+        } else {
+            for (const std::pair<int8_t, int8_t>& pawnMove : state.getValidPawnMoves()) {
+                GameState child = state;
+                child.movePawn(pawnMove.first, pawnMove.second);
+                children.push_back(child);
+            }
+        }
+        GameState next = children[std::uniform_int_distribution<size_t>(0, children.size() - 1)(randomGenerator)];
+        if (probability(randomGenerator) < 0.7) {
+            for (const GameState& child : children) {
+                int8_t childDistance = state.isPlayer1sTurn ? child.player1GoalDistance : child.player2GoalDistance;
+                int8_t nextDistance = state.isPlayer1sTurn ? next.player1GoalDistance : next.player2GoalDistance;
+                if (childDistance < nextDistance) {
+                    next = child;
+                }
+            }
+        }
+        game.moves.push_back(encodeMove(state, next));
+        state = next;
+    }
+    game.result = state.player1GoalDistance == 0 ? PLAYER_1_WON : state.player2GoalDistance == 0 ? PLAYER_2_WON : UNFINISHED;
+    game.finalStateHash = state.stateHash;
+    return game;
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "games.qgdb";
+    uint64_t gameCount = argc > 2 ? std::stoull(argv[2]) : 1000000;
+
+    std::mt19937 randomGenerator(1);
+    std::vector<RecordedGame> games;
+    for (int i = 0; i < DISTINCT_GAME_COUNT; i++) {
+        games.push_back(playRandomGame(randomGenerator));
+    }
+
+    auto writeStart = std::chrono::steady_clock::now();
+    {
+        GameDatabaseWriter writer(path);
+        for (uint64_t i = 0; i < gameCount; i++) {
+            const RecordedGame& game = games[i % games.size()];
+            writer.addGame(game.startState, game.moves, game.result);
+        }
+        writer.close();
+    }
+    double writeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - writeStart).count();
+
+    GameDatabaseReader reader(path);
+    if (reader.getGameCount() != gameCount) {
+        std::cerr << "Round trip failed: expected " << gameCount << " games, found " << reader.getGameCount() << "\n";
+        return 1;
+    }
+    // Every distinct game is replayed from its decoded starting position and must reach the same final state.
+    uint64_t checkedGameCount = std::min<uint64_t>(DISTINCT_GAME_COUNT, gameCount);
+    for (uint64_t i = 0; i < checkedGameCount; i++) {
+        GameRecordView view = reader.getGame(i);
+        const RecordedGame& game = games[i];
+        GameState state = decodePosition(view.startPosition);
+        if (!(encodePosition(state) == encodePosition(game.startState)) || state.stateHash != game.startState.stateHash ||
+            view.result != game.result || view.moveCount != game.moves.size()) {
+            std::cerr << "Round trip failed for game " << i << "\n";
+            return 1;
+        }
+        for (uint16_t m = 0; m < view.moveCount; m++) {
+            if (!isValidMove(state, view.moves[m])) {
+                std::cerr << "Illegal move read back in game " << i << "\n";
+                return 1;
+            }
+            applyMove(state, view.moves[m]);
+            if (!(decodePosition(encodePosition(state)).stateHash == state.stateHash)) {
+                std::cerr << "Position round trip failed in game " << i << "\n";
+                return 1;
+            }
+        }
+        if (state.stateHash != game.finalStateHash) {
+            std::cerr << "Replay round trip failed for game " << i << "\n";
+            return 1;
+        }
+    }
+
+    // The scan touches every byte of every game record the way an analysis pass would.
+    auto scanStart = std::chrono::steady_clock::now();
+    uint64_t moveCount = 0;
+    uint64_t checksum = 0;
+    int64_t resultSum = 0;
+    reader.forEachGame([&](const GameRecordView& game) {
+        checksum ^= game.startPosition.pawnsWallsAndTurn;
+        resultSum += game.result;
+        for (uint16_t m = 0; m < game.moveCount; m++) {
+            checksum += game.moves[m];
+        }
+        moveCount += game.moveCount;
+    });
+    double scanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - scanStart).count();
+    double databaseBytes = GAME_DATABASE_HEADER_SIZE + gameCount * (PACKED_POSITION_SIZE + 3 + 8) + moveCount;
+
+    std::cout << "Round trip verified for " << checkedGameCount << " distinct games\n";
+    std::cout << "Wrote " << gameCount << " games (" << databaseBytes / (1 << 20) << " MiB) in " << writeSeconds << " s\n";
+    std::cout << "Scanned " << gameCount << " games and " << moveCount << " moves in " << scanSeconds << " s: "
+              << gameCount / scanSeconds << " games/s, " << databaseBytes / (1 << 20) / scanSeconds << " MiB/s"
+              << " (checksum " << checksum << ", result sum " << resultSum << ")\n";
+    return 0;
+}
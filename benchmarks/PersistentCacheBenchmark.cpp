@@ -0,0 +1,80 @@
+// Measures what the persistent cache costs at startup and how often it is hit when the same positions
+// are analysed again by a restarted engine.
+// The positions of one game are each searched with an empty transposition table, first without the cache,
+// then with a new cache, and then again after the cache is closed and reopened as a new process would.
+// Usage: PersistentCacheBenchmark [cache path] [plies] [depth]
+#include <cstdio>
+#include <iostream>
+#include "../MiniMax.h"
+#include "../PersistentCache.h"
+
+struct RunResult {
+    double milliseconds;
+    uint64_t probes;
+    uint64_t hits;
+    uint64_t cutoffs;
+};
+
+RunResult analysePositions(const std::vector<GameState>& positions, int8_t depth) {
+    PersistentCacheStatistics before = persistentCache.getStatistics();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (const GameState& state : positions) {
+        transpositionTable.clear();
+        goalDistanceCache.clear();
+        transpositionTable.newSearch();
+        SearchContext context;
+        for (int8_t d = 1; d <= depth; d++) {
+            searchRoot(state, d, context);
+        }
+    }
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    PersistentCacheStatistics after = persistentCache.getStatistics();
+    return {milliseconds, after.probes - before.probes, after.hits - before.hits, after.cutoffs - before.cutoffs};
+}
+
+double timeOpen(const std::string& path) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    persistentCache.open(path, DEFAULT_PERSISTENT_CACHE_SIZE);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void printRun(const std::string& name, const RunResult& run) {
+    std::cout << name << ": " << run.milliseconds << " ms";
+    if (run.probes > 0) {
+        std::cout << ", " << run.hits << " hits of " << run.probes << " probes (" << 100.0 * run.hits / run.probes << "%), "
+                  << run.cutoffs << " saving a search (" << 100.0 * run.cutoffs / run.probes << "%)";
+    }
+    std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "analysis.qpcc";
+    int plies = argc > 2 ? std::stoi(argv[2]) : 8;
+    int8_t depth = argc > 3 ? std::stoi(argv[3]) : 3;
+
+    std::vector<GameState> positions = {GameState()};
+    for (int ply = 1; ply < plies && !positions.back().isGameOver(); ply++) {
+        SearchContext context;
+        positions.push_back(searchRoot(positions.back(), 2, context).bestMove);
+    }
+
+    // The first run also faults in the code and the transposition table, so it is not measured.
+    analysePositions(positions, depth);
+    RunResult withoutCache = analysePositions(positions, depth);
+
+    std::remove(path.c_str());
+    double createMilliseconds = timeOpen(path);
+    RunResult coldCache = analysePositions(positions, depth);
+    persistentCache.close();
+    double reopenMilliseconds = timeOpen(path);
+    RunResult warmCache = analysePositions(positions, depth);
+    persistentCache.close();
+
+    std::cout << "Analysed " << positions.size() << " positions to depth " << static_cast<int>(depth) << "\n";
+    std::cout << "Startup: creating a " << (DEFAULT_PERSISTENT_CACHE_SIZE * 16 >> 20) << " MiB cache took " << createMilliseconds
+              << " ms, reopening it took " << reopenMilliseconds << " ms, running without it costs nothing\n";
+    printRun("Without cache", withoutCache);
+    printRun("New cache", coldCache);
+    printRun("Reopened cache", warmCache);
+    return 0;
+}
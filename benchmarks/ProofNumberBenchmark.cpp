@@ -0,0 +1,70 @@
+// Measures how long proof number search takes to prove races that are forced wins for the player to move.
+// Each position gives the attacker a lead of at least LEAD moves over a defender with few walls, on an
+// otherwise open board, and reports the time and nodes taken and whether a win was proven.
+// Usage: ProofNumberBenchmark [node limit] [memory budget in bytes]
+#include <iostream>
+#include "../GameRecord.h"
+#include "../ProofNumberSearch.h"
+
+struct RacePosition {
+    std::pair<int8_t, int8_t> player1Position;
+    std::pair<int8_t, int8_t> player2Position;
+    int8_t player1WallCount;
+    int8_t player2WallCount;
+    bool isPlayer1sTurn;
+};
+
+GameState makePosition(const RacePosition& race) {
+    GameState state;
+    state.player1Position = race.player1Position;
+    state.player2Position = race.player2Position;
+    state.player1WallCount = race.player1WallCount;
+    state.player2WallCount = race.player2WallCount;
+    state.isPlayer1sTurn = race.isPlayer1sTurn;
+    state.computeStateHash();
+    state.setGoalDistances();
+    return state;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t nodeLimit = argc > 1 ? std::stoull(argv[1]) : 200000;
+    size_t memoryBudget = argc > 2 ? std::stoull(argv[2]) : DEFAULT_PROOF_MEMORY_BUDGET;
+    // Player 1 races to row 0 and player 2 to row 8.
+    std::vector<RacePosition> positions = {
+        {{4, 3}, {0, 2}, 0, 0, true},
+        {{4, 5}, {8, 1}, 3, 0, true},
+        {{2, 2}, {6, 3}, 0, 1, true},
+        {{4, 1}, {4, 4}, 0, 1, true},
+        {{7, 3}, {1, 2}, 2, 1, true},
+        {{4, 2}, {3, 3}, 0, 2, true},
+        {{0, 6}, {4, 5}, 0, 0, false},
+        {{5, 8}, {2, 6}, 1, 1, false},
+        // A collision in the default sized table once left this win unproven at the node limit.
+        {{8, 3}, {0, 3}, 0, 1, true},
+    };
+    int provenCount = 0;
+    double totalMilliseconds = 0.0;
+    for (const RacePosition& race : positions) {
+        GameState state = makePosition(race);
+        SearchContext context;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        ProofResult proof = solveRace(state, memoryBudget, nodeLimit, context);
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        totalMilliseconds += milliseconds;
+        provenCount += proof.proven;
+        std::cout << (state.isPlayer1sTurn ? "player 1" : "player 2") << " to move, distances "
+                  << static_cast<int>(state.player1GoalDistance) << "/" << static_cast<int>(state.player2GoalDistance)
+                  << ", walls " << static_cast<int>(state.player1WallCount) << "/" << static_cast<int>(state.player2WallCount)
+                  << (isRacePosition(state) ? "" : " (not a race)") << ": "
+                  << (proof.proven ? "proven" : "unproven") << " in " << context.nodes << " nodes, " << milliseconds << " ms";
+        if (proof.proven) {
+            std::cout << ", line";
+            for (uint8_t move : proof.winningLine) {
+                std::cout << " " << moveToString(move);
+            }
+        }
+        std::cout << "\n";
+    }
+    std::cout << provenCount << "/" << positions.size() << " proven in " << totalMilliseconds << " ms\n";
+    return 0;
+}
@@ -0,0 +1,98 @@
+// Measures how much faster later moves of a game are searched when the work of earlier searches is kept:
+// minimax keeps its transposition table between moves, and MCTS keeps the subtree of the move played.
+// Each is compared with starting every search from scratch, over the same sequence of moves.
+// Usage: SearchReuseBenchmark [plies] [minimax depth] [MCTS playouts per move]
+#include <iostream>
+#include "../GameRecord.h"
+#include "../MCTS.h"
+#include "../MiniMax.h"
+
+struct Measurement {
+    double milliseconds;
+    uint64_t nodes;
+};
+
+// Iterative deepening to the given depth, as the server searches.
+// The goal distance cache is cleared first so that neither run benefits from BFS results cached by the other.
+Measurement measureMinimax(const GameState& state, int8_t depth, GameState& bestMove) {
+    goalDistanceCache.clear();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    transpositionTable.newSearch();
+    SearchContext context;
+    for (int8_t d = 1; d <= depth; d++) {
+        bestMove = searchRoot(state, d, context).bestMove;
+    }
+    return {std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), context.nodes};
+}
+
+double measureMCTS(MCTSNode* root, int iterations) {
+    goalDistanceCache.clear();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    runMCTS(root, iterations);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int plies = argc > 1 ? std::stoi(argv[1]) : 12;
+    int8_t depth = argc > 2 ? std::stoi(argv[2]) : 3;
+    int playouts = argc > 3 ? std::stoi(argv[3]) : 3000;
+
+    // The game is played once with reuse enabled, and the moves chosen are replayed in the run without it.
+    std::vector<GameState> positions = {GameState()};
+    std::vector<Measurement> reused;
+    transpositionTable.clear();
+    for (int ply = 0; ply < plies && !positions.back().isGameOver(); ply++) {
+        GameState bestMove;
+        reused.push_back(measureMinimax(positions.back(), depth, bestMove));
+        positions.push_back(bestMove);
+    }
+    std::vector<Measurement> fresh;
+    for (size_t ply = 0; ply + 1 < positions.size(); ply++) {
+        transpositionTable.clear();
+        GameState bestMove;
+        fresh.push_back(measureMinimax(positions[ply], depth, bestMove));
+    }
+
+    std::cout << "Minimax to depth " << static_cast<int>(depth) << ", nodes and ms per move (fresh / reused):\n";
+    Measurement freshTotal = {0.0, 0};
+    Measurement reusedTotal = {0.0, 0};
+    for (size_t ply = 0; ply < reused.size(); ply++) {
+        std::cout << "  ply " << ply + 1 << ": " << fresh[ply].nodes << " / " << reused[ply].nodes << " nodes, "
+                  << fresh[ply].milliseconds << " / " << reused[ply].milliseconds << " ms\n";
+        if (ply > 0) {
+            freshTotal = {freshTotal.milliseconds + fresh[ply].milliseconds, freshTotal.nodes + fresh[ply].nodes};
+            reusedTotal = {reusedTotal.milliseconds + reused[ply].milliseconds, reusedTotal.nodes + reused[ply].nodes};
+        }
+    }
+    std::cout << "  second and later moves: " << freshTotal.nodes << " / " << reusedTotal.nodes << " nodes, "
+              << freshTotal.milliseconds << " / " << reusedTotal.milliseconds << " ms, "
+              << freshTotal.milliseconds / reusedTotal.milliseconds << "x faster\n";
+
+    // Each move needs the root to reach the same number of visits, so a promoted subtree
+    // starts part of the way there.
+    std::cout << "MCTS to " << playouts << " root visits, playouts run per move (fresh / reused):\n";
+    std::unique_ptr<MCTSNode> reusedRoot = std::make_unique<MCTSNode>(positions.front());
+    long freshPlayouts = 0;
+    long reusedPlayouts = 0;
+    double freshMilliseconds = 0.0;
+    double reusedMilliseconds = 0.0;
+    for (size_t ply = 0; ply + 1 < positions.size(); ply++) {
+        MCTSNode freshRoot(positions[ply]);
+        double freshTime = measureMCTS(&freshRoot, playouts);
+        int reusedRun = std::max(0, playouts - reusedRoot->visits);
+        double reusedTime = measureMCTS(reusedRoot.get(), reusedRun);
+        promoteChild(reusedRoot, positions[ply + 1]);
+
+        std::cout << "  ply " << ply + 1 << ": " << playouts << " / " << reusedRun << " playouts, "
+                  << freshTime << " / " << reusedTime << " ms\n";
+        if (ply > 0) {
+            freshPlayouts += playouts;
+            reusedPlayouts += reusedRun;
+            freshMilliseconds += freshTime;
+            reusedMilliseconds += reusedTime;
+        }
+    }
+    std::cout << "  second and later moves: " << freshPlayouts << " / " << reusedPlayouts << " playouts, "
+              << freshMilliseconds << " / " << reusedMilliseconds << " ms\n";
+    return 0;
+}
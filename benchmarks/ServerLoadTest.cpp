@@ -0,0 +1,92 @@
+// Plays many engine-versus-engine games at once through the server protocol and reports the
+// latency of every move, measured from sending go to receiving bestmove.
+// Usage: ServerLoadTest [sessions] [depth] [moves per game] [threads]
+#include <algorithm>
+#include <condition_variable>
+#include <iostream>
+#include <sstream>
+#include "../EngineServer.h"
+#include "../GameRecord.h"
+
+struct LoadTestSession {
+    GameState state;
+    int movesPlayed = 0;
+    std::chrono::steady_clock::time_point goSent;
+};
+
+int main(int argc, char* argv[]) {
+    int sessionCount = argc > 1 ? std::stoi(argv[1]) : 300;
+    std::string depth = argc > 2 ? argv[2] : "2";
+    int movesPerGame = argc > 3 ? std::stoi(argv[3]) : 20;
+    size_t threadCount = argc > 4 ? std::stoul(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+
+    // Replies arrive on worker threads and are handed to the main thread, which is the only
+    // thread allowed to send commands.
+    std::mutex replyMutex;
+    std::condition_variable replyAvailable;
+    std::vector<std::pair<std::string, std::chrono::steady_clock::time_point>> replies;
+    EngineServer server(threadCount, [&](const std::string& line) {
+        if (line.rfind("bestmove", 0) == 0 || line.rfind("error", 0) == 0) {
+            std::lock_guard<std::mutex> lock(replyMutex);
+            replies.push_back({line, std::chrono::steady_clock::now()});
+            replyAvailable.notify_one();
+        }
+    });
+
+    std::unordered_map<std::string, LoadTestSession> sessions;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < sessionCount; i++) {
+        std::string name = "s" + std::to_string(i);
+        sessions[name].goSent = std::chrono::steady_clock::now();
+        server.handleCommand("new " + name);
+        server.handleCommand("go " + name + " depth " + depth);
+    }
+
+    std::vector<double> latencies;
+    int activeSessions = sessionCount;
+    while (activeSessions > 0) {
+        std::vector<std::pair<std::string, std::chrono::steady_clock::time_point>> received;
+        {
+            std::unique_lock<std::mutex> lock(replyMutex);
+            replyAvailable.wait(lock, [&]() { return !replies.empty(); });
+            received.swap(replies);
+        }
+        for (const std::pair<std::string, std::chrono::steady_clock::time_point>& reply : received) {
+            std::istringstream tokens(reply.first);
+            std::string command;
+            std::string name;
+            std::string moveText;
+            tokens >> command >> name >> moveText;
+            if (command == "error") {
+                std::cerr << reply.first << "\n";
+                return 1;
+            }
+            LoadTestSession& session = sessions[name];
+            latencies.push_back(std::chrono::duration<double, std::milli>(reply.second - session.goSent).count());
+            uint8_t move = moveFromString(moveText);
+            if (move != NO_MOVE) {
+                applyMove(session.state, move);
+                session.movesPlayed++;
+            }
+            if (move == NO_MOVE || session.state.isGameOver() || session.movesPlayed == movesPerGame) {
+                server.handleCommand("delete " + name);
+                activeSessions--;
+                continue;
+            }
+            server.handleCommand("move " + name + " " + moveText);
+            session.goSent = std::chrono::steady_clock::now();
+            server.handleCommand("go " + name + " depth " + depth);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+    };
+    std::cout << sessionCount << " sessions, depth " << depth << ", " << threadCount << " threads\n";
+    std::cout << latencies.size() << " moves in " << seconds << " s (" << latencies.size() / seconds << " moves/s)\n";
+    std::cout << "Move latency ms: p50 " << percentile(0.50) << ", p90 " << percentile(0.90)
+              << ", p99 " << percentile(0.99) << ", max " << latencies.back() << "\n";
+    return 0;
+}
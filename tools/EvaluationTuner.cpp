@@ -0,0 +1,225 @@
+// Fits the evaluation weights to the results of recorded games with Texel style logistic regression
+// and writes them to EvaluationWeights.h, which the engine compiles in.
+// Every position of every finished game is labelled with that game's result, and the weights are
+// chosen so that a logistic function of the evaluation best predicts the label.
+// Usage: EvaluationTuner <games.qgdb> [output header] [threads] [iterations]
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include "../GameRecord.h"
+#include "../WorkerPool.h"
+
+const int FEATURE_COUNT = 5;
+const char* FEATURE_NAMES[FEATURE_COUNT] = {"GOAL_DISTANCE_WEIGHT", "WALL_COUNT_WEIGHT", "PATH_SLACK_WEIGHT", "MOBILITY_WEIGHT", "TURN_WEIGHT"};
+const int16_t CURRENT_WEIGHTS[FEATURE_COUNT] = {GOAL_DISTANCE_WEIGHT, WALL_COUNT_WEIGHT, PATH_SLACK_WEIGHT, MOBILITY_WEIGHT, TURN_WEIGHT};
+// The first comment line of EvaluationWeights.h, which the tuner writes in the same format as the checked in file.
+const char* EVALUATION_WEIGHTS_COMMENT = "// Evaluation weights, overwritten with tuned weights by tools/EvaluationTuner.cpp.";
+// The largest tuned weight is scaled to this value before the weights are rounded to integers.
+const double LARGEST_WEIGHT = 20.0;
+const double LEARNING_RATE = 1.0;
+
+struct TrainingSet {
+    // Features are stored row by row, one row of FEATURE_COUNT values per position.
+    std::vector<float> features;
+    // A label is 1 if player 1 won the game the position was taken from and 0 otherwise.
+    std::vector<float> labels;
+};
+
+// Splits [0, count) into one contiguous range per pool thread, runs the task on each range in parallel
+// and waits for every range to finish.
+template <typename Task>
+void parallelFor(WorkerPool& pool, size_t count, Task task) {
+    size_t rangeCount = pool.getThreadCount();
+    size_t remaining = rangeCount;
+    std::mutex mutex;
+    std::condition_variable finished;
+    for (size_t t = 0; t < rangeCount; t++) {
+        pool.submit([&, t]() {
+            task(t, count * t / rangeCount, count * (t + 1) / rangeCount);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--remaining == 0) {
+                finished.notify_one();
+            }
+        });
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&]() { return remaining == 0; });
+}
+
+// Games are replayed in parallel, each thread collecting the positions of its own range of games.
+// Throws std::runtime_error if a game record is corrupt or holds a move that is illegal where it is played.
+TrainingSet loadTrainingSet(const GameDatabaseReader& reader, WorkerPool& pool) {
+    std::vector<TrainingSet> threadSets(pool.getThreadCount());
+    std::atomic<bool> isCorrupt(false);
+    parallelFor(pool, reader.getGameCount(), [&](size_t thread, size_t begin, size_t end) {
+        TrainingSet& set = threadSets[thread];
+        for (size_t i = begin; i < end && !isCorrupt; i++) {
+            GameRecordView game;
+            try {
+                game = reader.getGame(i);
+            } catch (const std::runtime_error&) {
+                isCorrupt = true;
+                break;
+            }
+            if (game.result == UNFINISHED) {
+                continue;
+            }
+            GameState state = decodePosition(game.startPosition);
+            for (uint16_t m = 0; m <= game.moveCount && !state.isGameOver(); m++) {
+                EvaluationFeatures features = state.getEvaluationFeatures();
+                set.features.insert(set.features.end(), {
+                    static_cast<float>(features.goalDistance),
+                    static_cast<float>(features.wallCount),
+                    static_cast<float>(features.pathSlack),
+                    static_cast<float>(features.mobility),
+                    static_cast<float>(features.turn)});
+                set.labels.push_back(game.result == PLAYER_1_WON ? 1.0f : 0.0f);
+                if (m < game.moveCount) {
+                    if (!isValidMove(state, game.moves[m])) {
+                        isCorrupt = true;
+                        break;
+                    }
+                    applyMove(state, game.moves[m]);
+                }
+            }
+        }
+    });
+    if (isCorrupt) {
+        throw std::runtime_error("Corrupt game database");
+    }
+    TrainingSet trainingSet;
+    for (const TrainingSet& set : threadSets) {
+        trainingSet.features.insert(trainingSet.features.end(), set.features.begin(), set.features.end());
+        trainingSet.labels.insert(trainingSet.labels.end(), set.labels.begin(), set.labels.end());
+    }
+    return trainingSet;
+}
+
+// The mean log loss of predicting each label with sigmoid(weights . features), and its gradient.
+// Each thread accumulates the loss and gradient over its own batch of positions.
+double computeLoss(const TrainingSet& set, const std::vector<double>& weights, std::vector<double>& gradient, WorkerPool& pool) {
+    size_t threadCount = pool.getThreadCount();
+    size_t featureCount = weights.size();
+    size_t positionCount = set.labels.size();
+    std::vector<std::vector<double>> threadGradients(threadCount, std::vector<double>(featureCount, 0.0));
+    std::vector<double> threadLosses(threadCount, 0.0);
+    parallelFor(pool, positionCount, [&](size_t thread, size_t begin, size_t end) {
+        std::vector<double>& threadGradient = threadGradients[thread];
+        for (size_t i = begin; i < end; i++) {
+            const float* features = &set.features[i * featureCount];
+            double evaluation = 0.0;
+            for (size_t f = 0; f < featureCount; f++) {
+                evaluation += weights[f] * features[f];
+            }
+            double prediction = 1.0 / (1.0 + std::exp(-evaluation));
+            prediction = std::min(std::max(prediction, 1e-12), 1.0 - 1e-12);
+            threadLosses[thread] -= set.labels[i] * std::log(prediction) + (1.0 - set.labels[i]) * std::log(1.0 - prediction);
+            for (size_t f = 0; f < featureCount; f++) {
+                threadGradient[f] += (prediction - set.labels[i]) * features[f];
+            }
+        }
+    });
+    double loss = 0.0;
+    gradient.assign(featureCount, 0.0);
+    for (size_t t = 0; t < threadCount; t++) {
+        loss += threadLosses[t];
+        for (size_t f = 0; f < featureCount; f++) {
+            gradient[f] += threadGradients[t][f];
+        }
+    }
+    for (double& component : gradient) {
+        component /= positionCount;
+    }
+    return loss / positionCount;
+}
+
+// Features are rescaled to unit root mean square before gradient descent so that a single learning
+// rate suits every feature, and the weights are scaled back afterwards.
+std::vector<double> fitWeights(TrainingSet set, WorkerPool& pool, int iterations, double& loss) {
+    size_t featureCount = set.features.size() / set.labels.size();
+    std::vector<double> scales(featureCount, 0.0);
+    for (size_t i = 0; i < set.features.size(); i++) {
+        scales[i % featureCount] += set.features[i] * set.features[i];
+    }
+    for (double& scale : scales) {
+        scale = scale > 0.0 ? std::sqrt(scale / set.labels.size()) : 1.0;
+    }
+    for (size_t i = 0; i < set.features.size(); i++) {
+        set.features[i] /= scales[i % featureCount];
+    }
+    std::vector<double> weights(featureCount, 0.0);
+    std::vector<double> gradient;
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        loss = computeLoss(set, weights, gradient, pool);
+        for (size_t f = 0; f < featureCount; f++) {
+            weights[f] -= LEARNING_RATE * gradient[f];
+        }
+    }
+    loss = computeLoss(set, weights, gradient, pool);
+    for (size_t f = 0; f < featureCount; f++) {
+        weights[f] /= scales[f];
+    }
+    return weights;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: EvaluationTuner <games.qgdb> [output header] [threads] [iterations]\n";
+        return 1;
+    }
+    std::string outputPath = argc > 2 ? argv[2] : "EvaluationWeights.h";
+    size_t threadCount = argc > 3 ? std::stoul(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+    int iterations = argc > 4 ? std::stoi(argv[4]) : 500;
+
+    // One pool serves every parallel pass, so the threads are not restarted on each iteration.
+    WorkerPool pool(threadCount);
+    TrainingSet set;
+    uint64_t gameCount;
+    try {
+        GameDatabaseReader reader(argv[1]);
+        gameCount = reader.getGameCount();
+        set = loadTrainingSet(reader, pool);
+    } catch (const std::runtime_error& error) {
+        std::cerr << error.what() << "\n";
+        return 1;
+    }
+    if (set.labels.empty()) {
+        std::cerr << "No finished games in " << argv[1] << "\n";
+        return 1;
+    }
+    std::cout << "Loaded " << set.labels.size() << " positions from " << gameCount << " games\n";
+
+    // The current weights are measured by fitting only the scale that maps their evaluation to a win probability.
+    TrainingSet currentSet;
+    currentSet.labels = set.labels;
+    for (size_t i = 0; i < set.labels.size(); i++) {
+        float evaluation = 0.0f;
+        for (int f = 0; f < FEATURE_COUNT; f++) {
+            evaluation += CURRENT_WEIGHTS[f] * set.features[i * FEATURE_COUNT + f];
+        }
+        currentSet.features.push_back(evaluation);
+    }
+    double currentLoss;
+    fitWeights(currentSet, pool, iterations, currentLoss);
+    double tunedLoss;
+    std::vector<double> weights = fitWeights(set, pool, iterations, tunedLoss);
+    std::cout << "Log loss with current weights " << currentLoss << ", with tuned weights " << tunedLoss << "\n";
+
+    double largestWeight = 0.0;
+    for (double weight : weights) {
+        largestWeight = std::max(largestWeight, std::abs(weight));
+    }
+    std::ofstream header(outputPath);
+    header << "#pragma once\n\n#include <cstdint>\n\n";
+    header << EVALUATION_WEIGHTS_COMMENT << "\n";
+    header << "// Fitted to " << set.labels.size() << " positions from " << gameCount << " games with a log loss of " << tunedLoss << ".\n";
+    for (int f = 0; f < FEATURE_COUNT; f++) {
+        long weight = largestWeight > 0.0 ? std::lround(weights[f] * LARGEST_WEIGHT / largestWeight) : 0;
+        header << "constexpr int16_t " << FEATURE_NAMES[f] << " = " << weight << ";\n";
+        std::cout << FEATURE_NAMES[f] << " = " << weight << "\n";
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+// Serves the engine over the text protocol described in EngineServer.h on stdin and stdout.
+// Usage: QuoridorServer [threads] [hash MiB] [persistent cache path]
+// A local socket can be served by running it under a tool such as socat.
+#include <iostream>
+#include "../EngineServer.h"
+#include "../MiniMax.h"
+#include "../PersistentCache.h"
+
+int main(int argc, char* argv[]) {
+    size_t threadCount = argc > 1 ? std::stoul(argv[1]) : std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 2) {
+        // Each transposition table slot occupies 16 bytes.
+        transpositionTable.resize(std::stoull(argv[2]) * (1 << 20) / 16);
+    }
+    if (argc > 3 && !persistentCache.open(argv[3], DEFAULT_PERSISTENT_CACHE_SIZE)) {
+        std::cerr << "Failed to open persistent cache " << argv[3] << ", it may not be a cache or may have been written by a different engine build\n";
+        return 1;
+    }
+    std::ios::sync_with_stdio(false);
+    {
+        // The server finishes its running searches when it is destroyed, before the cache statistics are read.
+        EngineServer server(threadCount, [](const std::string& line) {
+            std::cout << line << std::endl;
+        });
+        std::string line;
+        while (std::getline(std::cin, line) && server.handleCommand(line)) {}
+    }
+    if (persistentCache.isOpen()) {
+        PersistentCacheStatistics statistics = persistentCache.getStatistics();
+        std::cerr << "Persistent cache hits: " << statistics.hits << " of " << statistics.probes
+                  << " probes, " << statistics.cutoffs << " of them saving a search\n";
+    }
+    return 0;
+}
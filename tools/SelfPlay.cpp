@@ -0,0 +1,73 @@
+// Plays engine-versus-engine games on every core and records them to a game database,
+// providing the labelled positions used by EvaluationTuner.
+// Usage: SelfPlay <output.qgdb> [games] [depth] [threads]
+#include <iostream>
+#include <random>
+#include "../GameRecord.h"
+#include "../MiniMax.h"
+#include "../WorkerPool.h"
+
+// Games open with a few random moves so that the engine does not replay the same game.
+const int RANDOM_OPENING_MOVES = 6;
+const int MAX_GAME_LENGTH = 200;
+
+struct SelfPlayGame {
+    std::vector<uint8_t> moves;
+    int8_t result;
+};
+
+SelfPlayGame playGame(int8_t depth, uint32_t seed) {
+    std::mt19937 randomGenerator(seed);
+    SelfPlayGame game;
+    GameState state;
+    while (!state.isGameOver() && game.moves.size() < MAX_GAME_LENGTH) {
+        GameState next;
+        if (game.moves.size() < RANDOM_OPENING_MOVES) {
+            std::vector<GameState> children = state.getValidMoves();
+            next = children[std::uniform_int_distribution<size_t>(0, children.size() - 1)(randomGenerator)];
+        } else {
+            transpositionTable.newSearch();
+            SearchContext context;
+            next = searchRoot(state, depth, context).bestMove;
+        }
+        game.moves.push_back(encodeMove(state, next));
+        state = next;
+    }
+    game.result = state.player1GoalDistance == 0 ? PLAYER_1_WON : state.player2GoalDistance == 0 ? PLAYER_2_WON : UNFINISHED;
+    return game;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: SelfPlay <output.qgdb> [games] [depth] [threads]\n";
+        return 1;
+    }
+    int gameCount = argc > 2 ? std::stoi(argv[2]) : 1000;
+    int8_t depth = argc > 3 ? std::stoi(argv[3]) : 2;
+    size_t threadCount = argc > 4 ? std::stoul(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+
+    GameDatabaseWriter writer(argv[1]);
+    std::mutex writerMutex;
+    int gamesWritten = 0;
+    {
+        WorkerPool workerPool(threadCount);
+        for (int i = 0; i < gameCount; i++) {
+            workerPool.submit([&, i]() {
+                SelfPlayGame game = playGame(depth, i);
+                std::lock_guard<std::mutex> lock(writerMutex);
+                writer.addGame(GameState(), game.moves, game.result);
+                gamesWritten++;
+                if (gamesWritten % 100 == 0) {
+                    std::cerr << gamesWritten << " games played\n";
+                }
+            });
+        }
+    }
+    try {
+        writer.close();
+    } catch (const std::runtime_error& error) {
+        std::cerr << error.what() << " " << argv[1] << "\n";
+        return 1;
+    }
+    return 0;
+}